@@ -0,0 +1,30 @@
+/*
+ * Print.h
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+// Minimal Arduino Print for building src/encoding on the host
+
+#ifndef PRINT_H
+#define PRINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+class Print
+{
+public:
+    virtual ~Print(void) {}
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+            n += write(*buffer++);
+        return n;
+    }
+    virtual void flush(void) {}
+};
+
+#endif // PRINT_H
@@ -0,0 +1,181 @@
+/*
+ * lzss.cpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+// Host tool for wiocellular::encoding::LzssCompressor
+//
+//   lzss c <input> <output>            Compress
+//   lzss d <input> <output>            Decompress
+//   lzss bench <records> [batchSize]   Compress batches of lines and report the ratio and speed
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "encoding/LzssCompressor.hpp"
+
+using wiocellular::encoding::LzssCompressor;
+
+class VectorPrint : public Print
+{
+public:
+    std::vector<uint8_t> data;
+
+    size_t write(uint8_t c) override
+    {
+        data.push_back(c);
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        data.insert(data.end(), buffer, buffer + size);
+        return size;
+    }
+};
+
+static VectorPrint Output;
+static LzssCompressor Compressor{Output};
+
+static std::vector<uint8_t> compress(const std::vector<uint8_t> &input)
+{
+    Output.data.clear();
+    Compressor.reset();
+    Compressor.write(input.data(), input.size());
+    Compressor.flush();
+    return Output.data;
+}
+
+static bool decompress(const std::vector<uint8_t> &input, std::vector<uint8_t> *output)
+{
+    output->clear();
+    size_t i = 0;
+    while (i < input.size())
+    {
+        const uint8_t flags = input[i++];
+        for (int bit = 0; bit < 8 && i < input.size(); ++bit)
+        {
+            if ((flags & 1 << bit) == 0)
+            {
+                output->push_back(input[i++]);
+                continue;
+            }
+            if (i + 2 > input.size())
+                return false;
+            const size_t distance = (input[i] | (input[i + 1] >> 5) << 8) + 1;
+            const size_t length = (input[i + 1] & 0x1f) + LzssCompressor::MIN_MATCH;
+            i += 2;
+            if (distance > output->size())
+                return false;
+            const size_t start = output->size() - distance;
+            for (size_t j = 0; j < length; ++j)
+                output->push_back((*output)[start + j]);
+        }
+    }
+    return true;
+}
+
+static bool readFile(const char *path, std::vector<uint8_t> *data)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+        return false;
+    data->assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    return true;
+}
+
+static bool writeFile(const char *path, const std::vector<uint8_t> &data)
+{
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
+
+static int bench(const char *path, size_t batchSize)
+{
+    std::ifstream file{path};
+    if (!file)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<std::string> records;
+    for (std::string line; std::getline(file, line);)
+        records.push_back(line + "\n");
+
+    std::vector<std::vector<uint8_t>> batches;
+    for (size_t i = 0; i < records.size(); i += batchSize)
+    {
+        std::vector<uint8_t> batch;
+        for (size_t j = i; j < i + batchSize && j < records.size(); ++j)
+            batch.insert(batch.end(), records[j].begin(), records[j].end());
+        batches.push_back(batch);
+    }
+
+    size_t inputSize = 0;
+    size_t outputSize = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::vector<uint8_t>> compressed;
+    for (const auto &batch : batches)
+    {
+        compressed.push_back(compress(batch));
+        inputSize += batch.size();
+        outputSize += compressed.back().size();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (size_t i = 0; i < batches.size(); ++i)
+    {
+        std::vector<uint8_t> restored;
+        if (!decompress(compressed[i], &restored) || restored != batches[i])
+        {
+            fprintf(stderr, "Round trip failed at batch %zu\n", i);
+            return 1;
+        }
+    }
+
+    printf("records    : %zu\n", records.size());
+    printf("batches    : %zu (%zu records each)\n", batches.size(), batchSize);
+    printf("input      : %zu bytes\n", inputSize);
+    printf("output     : %zu bytes\n", outputSize);
+    printf("ratio      : %.1f%%\n", 100.0 * outputSize / inputSize);
+    printf("throughput : %.1f MB/s (host)\n", inputSize / elapsed.count() / 1e6);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 3 && std::string{argv[1]} == "bench")
+        return bench(argv[2], argc >= 4 ? std::stoul(argv[3]) : 10);
+
+    if (argc != 4 || (std::string{argv[1]} != "c" && std::string{argv[1]} != "d"))
+    {
+        fprintf(stderr, "Usage: %s c|d <input> <output>\n", argv[0]);
+        fprintf(stderr, "       %s bench <records> [batchSize]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> input;
+    if (!readFile(argv[2], &input))
+    {
+        fprintf(stderr, "Cannot open %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<uint8_t> output;
+    if (std::string{argv[1]} == "c")
+    {
+        output = compress(input);
+    }
+    else if (!decompress(input, &output))
+    {
+        fprintf(stderr, "Corrupted input\n");
+        return 1;
+    }
+
+    return writeFile(argv[3], output) ? 0 : 1;
+}
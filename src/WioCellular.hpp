@@ -49,8 +49,57 @@ using WioCellularNetwork = wiocellular::network::Bg770aNetwork;
 
 extern WioCellularNetwork WioNetwork;
 
+#include "network/DnsResolver.hpp"
+
+using WioCellularDnsResolver = wiocellular::network::DnsResolver<WioCellularModule>;
+
+#include "network/TcpConnectionManager.hpp"
+
+using WioCellularTcpConnectionManager = wiocellular::network::TcpConnectionManager<WioCellularModule>;
+
+#include "network/CredentialManager.hpp"
+
+using WioCellularCredentialManager = wiocellular::network::CredentialManager<WioCellularModule>;
+
+#include "network/ResumableDownloader.hpp"
+
+template <typename STORAGE>
+using WioCellularResumableDownloader = wiocellular::network::ResumableDownloader<WioCellularModule, STORAGE>;
+
+#include "network/StoreAndForwardQueue.hpp"
+
+template <typename STORAGE>
+using WioCellularStoreAndForwardQueue = wiocellular::network::StoreAndForwardQueue<STORAGE>;
+
+#include "network/UplinkBatcher.hpp"
+
+using WioCellularUplinkBatcher = wiocellular::network::UplinkBatcher<WioCellularModule>;
+
+#include "network/SignalQualitySampler.hpp"
+
+using WioCellularSignalQualitySampler = wiocellular::network::SignalQualitySampler<WioCellularModule>;
+
+#include "network/PsmScheduler.hpp"
+
+using WioCellularPsmScheduler = wiocellular::network::PsmScheduler<WioCellularModule>;
+
 #endif
 
+#include "encoding/CborEncoder.hpp"
+
+using WioCellularCborEncoder = wiocellular::encoding::CborEncoder;
+
+#include "encoding/LzssCompressor.hpp"
+
+using WioCellularLzssCompressor = wiocellular::encoding::LzssCompressor;
+
+#include "client/WioCellularHttpClient.hpp"
+#include "client/WioCellularMqttClient.hpp"
+#include "client/WioCellularSocketClient.hpp"
+#include "client/WioCellularSocketPrint.hpp"
+#include "client/WioCellularSslClient.hpp"
 #include "client/WioCellularTcpClient.hpp"
+#include "client/WioCellularTcpServer.hpp"
+#include "client/WioCellularUdpClient.hpp"
 
 #endif // WIOCELLULAR_HPP
@@ -63,6 +63,16 @@ enum class WioCellularResult
      * 引数が範囲外
      */
     ArgumentOutOfRange = 9,
+    /**
+     * @~Japanese
+     * 名前解決でタイムアウト
+     */
+    DnsTimeout = 10,
+    /**
+     * @~Japanese
+     * 名前解決でエラー
+     */
+    DnsError = 11,
 };
 
 /**
@@ -85,6 +95,8 @@ static constexpr const char *WioCellularResultToString(WioCellularResult result)
                                                 : result == WioCellularResult::ReceiveTimeout       ? "ReceiveTimeout"
                                                 : result == WioCellularResult::NotActivate          ? "NotActivate"
                                                 : result == WioCellularResult::ArgumentOutOfRange   ? "ArgumentOutOfRange"
+                                                : result == WioCellularResult::DnsTimeout           ? "DnsTimeout"
+                                                : result == WioCellularResult::DnsError             ? "DnsError"
                                                                                                     : "Unknown";
 }
 
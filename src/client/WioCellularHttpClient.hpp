@@ -0,0 +1,217 @@
+/*
+ * WioCellularHttpClient.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARHTTPCLIENT_HPP
+#define WIOCELLULARHTTPCLIENT_HPP
+
+#include "../WioCellular.hpp"
+#include <array>
+#include <functional>
+
+/**
+ * @~Japanese
+ * @brief HTTP(S)クライアント
+ *
+ * @tparam MODULE モジュールのクラス
+ * @tparam CHUNK_SIZE レスポンスボディを受け渡す単位[バイト]
+ *
+ * モジュール内蔵のHTTP(S)クライアント(AT+QHTTP*)を使うHTTPクライアントのクラスです。
+ * HTTPの解析はモジュールで行い、レスポンスボディはCHUNK_SIZEずつ呼び出し元の関数へ渡します。
+ * URLが"https://"で始まるときは、コンストラクタで指定したSSLコンテキストを使います。
+ */
+template <typename MODULE, size_t CHUNK_SIZE = 512>
+class WioCellularHttpClient
+{
+public:
+    /**
+     * @~Japanese
+     * @brief レスポンスボディを受け取る関数の型
+     *
+     * 読み込んだデータとサイズを受け取ります。falseを返すと残りのデータを破棄します。
+     */
+    using SinkType = std::function<bool(const void *data, size_t dataSize)>;
+
+    /**
+     * @~Japanese
+     * @brief Content-Type
+     */
+    enum class ContentType
+    {
+        /**
+         * @~Japanese
+         * @brief application/x-www-form-urlencoded
+         */
+        FormUrlEncoded = 0,
+        /**
+         * @~Japanese
+         * @brief text/plain
+         */
+        TextPlain = 1,
+        /**
+         * @~Japanese
+         * @brief application/octet-stream
+         */
+        OctetStream = 2,
+        /**
+         * @~Japanese
+         * @brief multipart/form-data
+         */
+        MultipartFormData = 3,
+        /**
+         * @~Japanese
+         * @brief application/json
+         */
+        ApplicationJson = 4,
+        /**
+         * @~Japanese
+         * @brief image/jpeg
+         */
+        ImageJpeg = 5,
+    };
+
+    /**
+     * @~Japanese
+     * @brief HTTPの設定
+     */
+    struct
+    {
+        /**
+         * @~Japanese
+         * @brief レスポンスを待つ時間[秒]
+         */
+        int responseTime;
+    } config;
+
+private:
+    MODULE &Module_;
+    int PdpContextId_;
+    int SslContextId_;
+    bool Configured_;
+    std::array<uint8_t, CHUNK_SIZE> Chunk_;
+
+    WioCellularResult prepare(const char *url)
+    {
+        WioCellularResult result;
+
+        if (!Configured_)
+        {
+            if ((result = Module_.setHttpOption("contextid", wiocellular::internal::stringFormat("%d", PdpContextId_))) != WioCellularResult::Ok)
+            {
+                return result;
+            }
+            if ((result = Module_.setHttpOption("sslctxid", wiocellular::internal::stringFormat("%d", SslContextId_))) != WioCellularResult::Ok)
+            {
+                return result;
+            }
+            if ((result = Module_.setHttpOption("requestheader", "0")) != WioCellularResult::Ok)
+            {
+                return result;
+            }
+            if ((result = Module_.setHttpOption("responseheader", "0")) != WioCellularResult::Ok)
+            {
+                return result;
+            }
+            Configured_ = true;
+        }
+
+        return Module_.setHttpUrl(url);
+    }
+
+    WioCellularResult readBody(size_t contentLength, const SinkType &sink)
+    {
+        if (contentLength == 0 || !sink)
+            return WioCellularResult::Ok;
+
+        return Module_.readHttp(contentLength, Chunk_.data(), Chunk_.size(), sink, config.responseTime);
+    }
+
+public:
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] pdpContextId PDPコンテキストID。
+     * @param [in] sslContextId HTTPSで使うSSLコンテキストID。
+     *
+     * コンストラクタ。
+     */
+    WioCellularHttpClient(MODULE &module, int pdpContextId, int sslContextId) : config{60},
+                                                                                Module_{module},
+                                                                                PdpContextId_{pdpContextId},
+                                                                                SslContextId_{sslContextId},
+                                                                                Configured_{false},
+                                                                                Chunk_{}
+    {
+    }
+
+    /**
+     * @~Japanese
+     * @brief GETリクエスト
+     *
+     * @param [in] url URL。
+     * @param [in] sink レスポンスボディを受け取る関数。nullptrを指定するとボディを読み込みません。
+     * @param [out] httpStatus HTTPステータスコード。nullptrを指定すると値を代入しません。
+     * @return 実行結果。
+     *
+     * GETリクエストを送信して、レスポンスボディをsinkへ渡します。
+     * Content-Lengthが無いレスポンスのボディは読み込みません。
+     */
+    WioCellularResult get(const char *url, const SinkType &sink, int *httpStatus)
+    {
+        WioCellularResult result;
+
+        if ((result = prepare(url)) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        size_t contentLength;
+        if ((result = Module_.getHttp(config.responseTime, httpStatus, &contentLength)) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+
+        return readBody(contentLength, sink);
+    }
+
+    /**
+     * @~Japanese
+     * @brief POSTリクエスト
+     *
+     * @param [in] url URL。
+     * @param [in] contentType リクエストボディのContent-Type。
+     * @param [in] data リクエストボディ。
+     * @param [in] dataSize リクエストボディのサイズ。
+     * @param [in] sink レスポンスボディを受け取る関数。nullptrを指定するとボディを読み込みません。
+     * @param [out] httpStatus HTTPステータスコード。nullptrを指定すると値を代入しません。
+     * @return 実行結果。
+     *
+     * POSTリクエストを送信して、レスポンスボディをsinkへ渡します。
+     * Content-Lengthが無いレスポンスのボディは読み込みません。
+     */
+    WioCellularResult post(const char *url, ContentType contentType, const void *data, size_t dataSize, const SinkType &sink, int *httpStatus)
+    {
+        WioCellularResult result;
+
+        if ((result = prepare(url)) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        if ((result = Module_.setHttpOption("contenttype", wiocellular::internal::stringFormat("%d", static_cast<int>(contentType)))) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        size_t contentLength;
+        if ((result = Module_.postHttp(data, dataSize, config.responseTime, httpStatus, &contentLength)) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+
+        return readBody(contentLength, sink);
+    }
+};
+
+#endif // WIOCELLULARHTTPCLIENT_HPP
@@ -0,0 +1,544 @@
+/*
+ * WioCellularMqttClient.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARMQTTCLIENT_HPP
+#define WIOCELLULARMQTTCLIENT_HPP
+
+#include "../WioCellular.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+#include "internal/RingBuffer.hpp"
+
+/**
+ * @~Japanese
+ * @brief MQTTクライアント
+ *
+ * @tparam MODULE モジュールのクラス
+ * @tparam MESSAGE_COUNT 受信メッセージを保持する数
+ * @tparam TOPIC_SIZE_MAX 受信メッセージのトピックの最大サイズ(終端文字を含む)
+ * @tparam PAYLOAD_SIZE_MAX 受信メッセージのペイロードの最大サイズ
+ *
+ * モジュール内蔵のMQTTクライアント(AT+QMT*)を使うMQTTクライアントのクラスです。
+ * 受信したメッセージ(+QMTRECV)は、あらかじめ確保したメッセージバッファに格納します。
+ * QoS1の発行は、PUBAckを待たずに最大PUBLISH_WINDOW個まで続けて送信します。
+ * PUBLISH_ACK_TIMEOUTを過ぎてもPUBAckの通知(+QMTPUB)が無いメッセージは、送信失敗として扱います。
+ * モジュールはペイロードをURCの文字列として通知するので、受信できるペイロードは改行と制御文字を含まないテキストに限られます。
+ */
+template <typename MODULE, size_t MESSAGE_COUNT = 4, size_t TOPIC_SIZE_MAX = 128, size_t PAYLOAD_SIZE_MAX = 512>
+class WioCellularMqttClient
+{
+public:
+    /**
+     * @~Japanese
+     * @brief PUBAckを待たずに送信するQoS1メッセージの最大数
+     */
+    static constexpr size_t PUBLISH_WINDOW = 8;
+
+    /**
+     * @~Japanese
+     * @brief QoS1メッセージのPUBAckを待つ最大時間[ミリ秒]
+     */
+    static constexpr uint32_t PUBLISH_ACK_TIMEOUT = 60000;
+
+    /**
+     * @~Japanese
+     * @brief 受信メッセージ
+     */
+    struct Message
+    {
+        /**
+         * @~Japanese
+         * @brief トピック
+         */
+        char topic[TOPIC_SIZE_MAX];
+        /**
+         * @~Japanese
+         * @brief ペイロード
+         */
+        uint8_t payload[PAYLOAD_SIZE_MAX];
+        /**
+         * @~Japanese
+         * @brief ペイロードのサイズ
+         */
+        size_t payloadSize;
+        /**
+         * @~Japanese
+         * @brief トピックかペイロードを切り詰めたか
+         */
+        bool truncated;
+    };
+
+private:
+    using UrcHandlerIterator = decltype(std::declval<MODULE &>().registerUrcHandler(nullptr));
+
+    MODULE &Module_;
+    int PdpContextId_;
+    int ClientIndex_;
+    bool Opened_;
+    bool Connected_;
+    bool UrcHandlerRegistered_;
+    UrcHandlerIterator UrcHandler_;
+    wiocellular::internal::RingBuffer<Message, MESSAGE_COUNT> Messages_;
+    size_t DroppedMessageCount_;
+    int NextMessageId_;
+    std::array<uint16_t, PUBLISH_WINDOW> InFlightIds_;
+    std::array<uint32_t, PUBLISH_WINDOW> InFlightTimes_;
+    size_t InFlightCount_;
+    size_t PublishFailedCount_;
+
+    int nextMessageId(void)
+    {
+        const auto messageId = NextMessageId_;
+        NextMessageId_ = NextMessageId_ >= 65535 ? 1 : NextMessageId_ + 1;
+        return messageId;
+    }
+
+    void acknowledge(int messageId, bool failed)
+    {
+        for (size_t i = 0; i < InFlightCount_; ++i)
+        {
+            if (InFlightIds_[i] == messageId)
+            {
+                --InFlightCount_;
+                InFlightIds_[i] = InFlightIds_[InFlightCount_];
+                InFlightTimes_[i] = InFlightTimes_[InFlightCount_];
+                if (failed)
+                    ++PublishFailedCount_;
+                return;
+            }
+        }
+    }
+
+    // Gives up on messages whose +QMTPUB was lost, so that their slots do not leak
+    void expireInFlight(void)
+    {
+        const auto now = millis();
+        for (size_t i = 0; i < InFlightCount_;)
+        {
+            if (now - InFlightTimes_[i] >= PUBLISH_ACK_TIMEOUT)
+            {
+                --InFlightCount_;
+                InFlightIds_[i] = InFlightIds_[InFlightCount_];
+                InFlightTimes_[i] = InFlightTimes_[InFlightCount_];
+                ++PublishFailedCount_;
+                continue;
+            }
+            ++i;
+        }
+    }
+
+    void storeMessage(const std::string &responseParameter)
+    {
+        // <msgId>,"<topic>",<payload_len>,"<payload>"
+        const auto topicStart = responseParameter.find('"');
+        if (topicStart == std::string::npos)
+            return;
+        const auto topicEnd = responseParameter.find('"', topicStart + 1);
+        if (topicEnd == std::string::npos)
+            return;
+        const auto payloadStart = responseParameter.find('"', topicEnd + 1);
+        if (payloadStart == std::string::npos || responseParameter.back() != '"' || payloadStart + 1 >= responseParameter.size())
+            return;
+
+        if (Messages_.full())
+        {
+            ++DroppedMessageCount_;
+            return;
+        }
+
+        size_t regionSize;
+        Message *message = Messages_.writableRegion(&regionSize);
+
+        const auto topicSize = topicEnd - topicStart - 1;
+        const auto topicCopySize = std::min(topicSize, TOPIC_SIZE_MAX - 1);
+        memcpy(message->topic, &responseParameter[topicStart + 1], topicCopySize);
+        message->topic[topicCopySize] = '\0';
+
+        const auto payloadSize = responseParameter.size() - payloadStart - 2;
+        message->payloadSize = std::min(payloadSize, PAYLOAD_SIZE_MAX);
+        memcpy(message->payload, &responseParameter[payloadStart + 1], message->payloadSize);
+
+        message->truncated = topicCopySize < topicSize || message->payloadSize < payloadSize;
+
+        Messages_.commit(1);
+    }
+
+    bool handleUrc(const std::string &response)
+    {
+        std::string responseParameter;
+        if (wiocellular::internal::stringStartsWith(response, wiocellular::internal::stringFormat("+QMTRECV: %d,", ClientIndex_), &responseParameter))
+        {
+            storeMessage(responseParameter);
+            return true;
+        }
+        if (wiocellular::internal::stringStartsWith(response, wiocellular::internal::stringFormat("+QMTPUB: %d,", ClientIndex_), &responseParameter))
+        {
+            wiocellular::module::at_client::AtParameterParser parser{responseParameter};
+            if (parser.size() < 2)
+                return false;
+            // <result> 0: Sent successfully, 1: Retransmission, 2: Failed to send
+            if (parser[1] != "1")
+                acknowledge(std::stoi(parser[0]), parser[1] != "0");
+            return true;
+        }
+        if (wiocellular::internal::stringStartsWith(response, wiocellular::internal::stringFormat("+QMTSTAT: %d,", ClientIndex_), &responseParameter))
+        {
+            printf("---> MQTT disconnected (clientIndex=%d,error=%s)\n", ClientIndex_, responseParameter.c_str());
+            Connected_ = false;
+            return true;
+        }
+        return false;
+    }
+
+    WioCellularResult waitInFlight(size_t count, int timeout)
+    {
+        const auto start = millis();
+        while (true)
+        {
+            expireInFlight();
+            if (InFlightCount_ <= count)
+                break;
+            if (!Connected_)
+                return WioCellularResult::CommandRejected;
+            if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                return WioCellularResult::ReadResponseTimeout;
+            Module_.doWork(timeout - (millis() - start));
+        }
+
+        return WioCellularResult::Ok;
+    }
+
+public:
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] pdpContextId PDPコンテキストID。
+     * @param [in] clientIndex クライアントのインデックス。0～5
+     *
+     * コンストラクタ。
+     */
+    WioCellularMqttClient(MODULE &module, int pdpContextId, int clientIndex) : Module_{module},
+                                                                               PdpContextId_{pdpContextId},
+                                                                               ClientIndex_{clientIndex},
+                                                                               Opened_{false},
+                                                                               Connected_{false},
+                                                                               UrcHandlerRegistered_{false},
+                                                                               UrcHandler_{},
+                                                                               Messages_{},
+                                                                               DroppedMessageCount_{0},
+                                                                               NextMessageId_{1},
+                                                                               InFlightIds_{},
+                                                                               InFlightTimes_{},
+                                                                               InFlightCount_{0},
+                                                                               PublishFailedCount_{0}
+    {
+    }
+
+    /**
+     * @~Japanese
+     * @brief デストラクタ
+     *
+     * デストラクタ。
+     */
+    virtual ~WioCellularMqttClient(void)
+    {
+        stop();
+        if (UrcHandlerRegistered_)
+            Module_.unregisterUrcHandler(UrcHandler_);
+    }
+
+    /**
+     * @~Japanese
+     * @brief MQTTサーバーに接続
+     *
+     * @param [in] host ホスト名もしくはIPアドレス。
+     * @param [in] port ポート番号。
+     * @param [in] clientId クライアントID。
+     * @param [in] userName ユーザー名。空文字列を指定すると省略します。
+     * @param [in] password パスワード。空文字列を指定すると省略します。
+     * @param [in] keepalive キープアライブ時間[秒]。
+     * @return 実行結果。
+     *
+     * MQTT 3.1.1でMQTTサーバーに接続します。
+     */
+    WioCellularResult connect(const char *host, uint16_t port, const char *clientId, const char *userName = "", const char *password = "", int keepalive = 120)
+    {
+        if (Opened_)
+            stop();
+
+        if (!UrcHandlerRegistered_)
+        {
+            UrcHandler_ = Module_.registerUrcHandler([this](const std::string &response) -> bool
+                                                     { return handleUrc(response); });
+            UrcHandlerRegistered_ = true;
+        }
+
+        WioCellularResult result;
+
+        if ((result = Module_.setMqttOption(ClientIndex_, "pdpcid", wiocellular::internal::stringFormat("%d", PdpContextId_))) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        if ((result = Module_.setMqttOption(ClientIndex_, "version", "4")) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        if ((result = Module_.setMqttOption(ClientIndex_, "keepalive", wiocellular::internal::stringFormat("%d", keepalive))) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        // Receive messages in the URC with the payload length
+        if ((result = Module_.setMqttOption(ClientIndex_, "recv/mode", "0,1")) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+
+        if ((result = Module_.openMqtt(ClientIndex_, host, port)) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        Opened_ = true;
+
+        if ((result = Module_.connectMqtt(ClientIndex_, clientId, userName, password)) != WioCellularResult::Ok)
+        {
+            stop();
+            return result;
+        }
+        Connected_ = true;
+        InFlightCount_ = 0;
+
+        return WioCellularResult::Ok;
+    }
+
+    /**
+     * @~Japanese
+     * @brief MQTTサーバーから切断
+     *
+     * MQTTサーバーから切断します。
+     */
+    void stop(void)
+    {
+        if (Connected_)
+            Module_.disconnectMqtt(ClientIndex_);
+        else if (Opened_)
+            Module_.closeMqtt(ClientIndex_);
+
+        Opened_ = false;
+        Connected_ = false;
+        InFlightCount_ = 0;
+    }
+
+    /**
+     * @~Japanese
+     * @brief MQTTサーバーの接続状態を取得
+     *
+     * @retval true 接続
+     * @retval false 切断
+     *
+     * MQTTサーバーの接続状態を取得します。
+     * URCの処理を行うだけで、ATコマンドは送信しません。
+     */
+    bool connected(void)
+    {
+        if (!Connected_)
+            return false;
+
+        Module_.doWork(0); // Process pending URCs without sending AT command
+
+        return Connected_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief メッセージを発行
+     *
+     * @param [in] topic トピック。
+     * @param [in] data データ。
+     * @param [in] dataSize データサイズ。
+     * @param [in] qos QoS。0もしくは1
+     * @param [in] retain リテイン。
+     * @param [in] timeout 送信中のメッセージが減るのを待つタイムアウト時間[ミリ秒]。
+     * @return 実行結果。
+     *
+     * メッセージを発行します。
+     * QoS1のときもPUBAckを待たずに戻ります。
+     * PUBAckを待っているメッセージがPUBLISH_WINDOW個あるときだけ、PUBAckを受信するまで待ちます。
+     */
+    WioCellularResult publish(const char *topic, const void *data, size_t dataSize, int qos = 0, bool retain = false, int timeout = 30000)
+    {
+        assert(qos == 0 || qos == 1);
+
+        if (!connected())
+            return WioCellularResult::CommandRejected;
+
+        WioCellularResult result;
+
+        if (qos == 0)
+        {
+            return Module_.publishMqtt(ClientIndex_, 0, 0, retain, topic, data, dataSize);
+        }
+
+        if ((result = waitInFlight(PUBLISH_WINDOW - 1, timeout)) != WioCellularResult::Ok)
+        {
+            return result;
+        }
+        // Register before sending because the +QMTPUB may arrive before OK
+        const auto messageId = nextMessageId();
+        InFlightIds_[InFlightCount_] = messageId;
+        InFlightTimes_[InFlightCount_] = millis();
+        ++InFlightCount_;
+        if ((result = Module_.publishMqtt(ClientIndex_, messageId, qos, retain, topic, data, dataSize)) != WioCellularResult::Ok)
+        {
+            acknowledge(messageId, false);
+            return result;
+        }
+
+        return WioCellularResult::Ok;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 発行したメッセージのPUBAckを待つ
+     *
+     * @param [in] timeout タイムアウト時間[ミリ秒]。
+     * @return 実行結果。
+     *
+     * PUBAckを待っているQoS1のメッセージが無くなるまで待ちます。
+     * 送信に失敗したメッセージの数はgetPublishFailedCount()で取得できます。
+     */
+    WioCellularResult flush(int timeout = 30000)
+    {
+        return waitInFlight(0, timeout);
+    }
+
+    /**
+     * @~Japanese
+     * @brief トピックを購読
+     *
+     * @param [in] topic トピック。
+     * @param [in] qos QoS。0もしくは1
+     * @return 実行結果。
+     *
+     * トピックを購読します。
+     */
+    WioCellularResult subscribe(const char *topic, int qos = 0)
+    {
+        assert(qos == 0 || qos == 1);
+
+        if (!connected())
+            return WioCellularResult::CommandRejected;
+
+        return Module_.subscribeMqtt(ClientIndex_, nextMessageId(), topic, qos);
+    }
+
+    /**
+     * @~Japanese
+     * @brief トピックの購読を解除
+     *
+     * @param [in] topic トピック。
+     * @return 実行結果。
+     *
+     * トピックの購読を解除します。
+     */
+    WioCellularResult unsubscribe(const char *topic)
+    {
+        if (!connected())
+            return WioCellularResult::CommandRejected;
+
+        return Module_.unsubscribeMqtt(ClientIndex_, nextMessageId(), topic);
+    }
+
+    /**
+     * @~Japanese
+     * @brief 未読のメッセージ数を取得
+     *
+     * @return 未読のメッセージ数。
+     *
+     * URCを処理して、未読のメッセージ数を取得します。
+     */
+    size_t available(void)
+    {
+        Module_.doWork(0); // Process pending URCs without sending AT command
+
+        return Messages_.size();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 先頭のメッセージを参照
+     *
+     * @return メッセージ。未読のメッセージが無いときはnullptr。
+     *
+     * 先頭のメッセージをコピーせずに参照します。
+     * 参照したメッセージはpop()で破棄してください。
+     */
+    const Message *front(void)
+    {
+        if (available() == 0)
+            return nullptr;
+
+        return &Messages_.front();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 先頭のメッセージを破棄
+     *
+     * 先頭のメッセージを破棄します。
+     */
+    void pop(void)
+    {
+        if (Messages_.empty())
+            return;
+
+        Messages_.pop();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 破棄したメッセージ数を取得
+     *
+     * @return 破棄したメッセージ数。
+     *
+     * メッセージバッファが満杯で破棄した受信メッセージの数を取得します。
+     */
+    size_t getDroppedMessageCount(void) const
+    {
+        return DroppedMessageCount_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief PUBAckを待っているメッセージ数を取得
+     *
+     * @return PUBAckを待っているQoS1のメッセージ数。
+     *
+     * PUBAckを待っているQoS1のメッセージ数を取得します。
+     */
+    size_t getInFlightCount(void) const
+    {
+        return InFlightCount_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信に失敗したメッセージ数を取得
+     *
+     * @return 送信に失敗したメッセージ数。
+     *
+     * モジュールが再送しても送信できなかったQoS1のメッセージと、PUBLISH_ACK_TIMEOUTを過ぎてもPUBAckの通知が無かったQoS1のメッセージの数を取得します。
+     */
+    size_t getPublishFailedCount(void) const
+    {
+        return PublishFailedCount_;
+    }
+};
+
+#endif // WIOCELLULARMQTTCLIENT_HPP
@@ -0,0 +1,347 @@
+/*
+ * WioCellularSocketClient.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARSOCKETCLIENT_HPP
+#define WIOCELLULARSOCKETCLIENT_HPP
+
+#include "../WioCellular.hpp"
+#include <Client.h>
+#include "internal/RingBuffer.hpp"
+
+/**
+ * @~Japanese
+ * @brief ソケットクライアントの共通部分
+ *
+ * @tparam DERIVED 派生クラス
+ * @tparam MODULE モジュールのクラス
+ *
+ * モジュールのソケットを使うクライアントの共通部分です。受信バッファと、URCで受信を判断する処理を持ちます。
+ * 派生クラスは、次のソケット操作を実装します。
+ * - WioCellularResult openModuleSocket(const char *host, uint16_t port)
+ * - WioCellularResult sendModuleSocket(const void *data, size_t dataSize)
+ * - WioCellularResult receiveModuleSocket(void *data, size_t dataSize, size_t *receivedDataSize)
+ * - WioCellularResult closeModuleSocket(void)
+ * - bool isModuleSocketReceiveNotified(void)
+ * - bool isModuleSocketClosedNotified(void)
+ */
+template <typename DERIVED, typename MODULE>
+class WioCellularSocketClient : public Client
+{
+protected:
+    static constexpr size_t RECEIVE_MAX_LENGTH = 1500;
+
+    MODULE &Module_;
+    int PdpContextId_;
+    bool Connected_;
+    bool ModuleReceivePending_; // There may be unread data in the module
+    wiocellular::internal::RingBuffer<uint8_t, RECEIVE_MAX_LENGTH> ReceiveBuffer_;
+
+    DERIVED &derived(void)
+    {
+        return static_cast<DERIVED &>(*this);
+    }
+
+    /**
+     * @~Japanese
+     * @brief モジュールから受信
+     *
+     * @retval true 成功
+     * @retval false エラー
+     *
+     * 受信通知のURCがあったとき、もしくはモジュール内に未読のデータが残っているときだけ、モジュールから受信バッファへ読み込みます。
+     * 受信バッファの空き領域へ直接読み込みます。
+     */
+    bool receiveFromModule(void)
+    {
+        if (ReceiveBuffer_.full())
+            return true;
+
+        Module_.doWork(0); // Process pending URCs without sending AT command
+        if (!ModuleReceivePending_ && !derived().isModuleSocketReceiveNotified())
+            return true;
+
+        size_t regionSize;
+        uint8_t *region = ReceiveBuffer_.writableRegion(&regionSize);
+        size_t size;
+        if (derived().receiveModuleSocket(region, regionSize, &size) != WioCellularResult::Ok)
+            return false;
+        ReceiveBuffer_.commit(size);
+
+        // Filling the whole region means that the module may have more data.
+        // The module does not notify again until its buffer has been read dry.
+        ModuleReceivePending_ = size >= regionSize;
+
+        return true;
+    }
+
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] pdpContextId PDPコンテキスト。
+     *
+     * コンストラクタ。
+     */
+    WioCellularSocketClient(MODULE &module, int pdpContextId) : Module_{module},
+                                                                PdpContextId_{pdpContextId},
+                                                                Connected_{false},
+                                                                ModuleReceivePending_{false},
+                                                                ReceiveBuffer_{}
+    {
+    }
+
+public:
+    /**
+     * @~Japanese
+     * @brief サーバーに接続
+     *
+     * @param [in] ip IPアドレス。
+     * @param [in] port ポート番号。
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * サーバーに接続します。
+     */
+    virtual int connect(IPAddress ip, uint16_t port)
+    {
+        if (Connected_)
+            return 0;
+
+        String ipStr = String(ip[0]);
+        ipStr += ".";
+        ipStr += String(ip[1]);
+        ipStr += ".";
+        ipStr += String(ip[2]);
+        ipStr += ".";
+        ipStr += String(ip[3]);
+
+        return connect(ipStr.c_str(), port);
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーに接続
+     *
+     * @param [in] host ホスト名。
+     * @param [in] port ポート番号。
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * サーバーに接続します。
+     */
+    virtual int connect(const char *host, uint16_t port)
+    {
+        if (Connected_)
+            return 0;
+
+        if (derived().openModuleSocket(host, port) != WioCellularResult::Ok)
+            return 0;
+
+        Connected_ = true;
+        ModuleReceivePending_ = false;
+        ReceiveBuffer_.clear();
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーへ送信
+     *
+     * @param [in] data データ。
+     * @return 送信したデータサイズ。
+     *
+     * サーバーへ送信します。
+     */
+    virtual size_t write(uint8_t data)
+    {
+        return write(&data, 1);
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーへ送信
+     *
+     * @param [in] buf データ。
+     * @param [in] size データサイズ。
+     * @return 送信したデータサイズ。
+     *
+     * サーバーへ送信します。
+     */
+    virtual size_t write(const uint8_t *buf, size_t size)
+    {
+        if (!Connected_)
+            return 0;
+
+        if (derived().sendModuleSocket(buf, size) != WioCellularResult::Ok)
+            return 0;
+
+        return size;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 未読のデータサイズを取得
+     *
+     * @retval >=0 未読のデータサイズ
+     * @retval <0 エラー
+     *
+     * サーバーから受信した、未読のデータサイズを取得します。
+     * エラーのときは負の値を返します。
+     */
+    virtual int available(void)
+    {
+        if (!Connected_)
+            return -1;
+
+        if (!receiveFromModule())
+            return -1;
+
+        return ReceiveBuffer_.size();
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーから受信
+     *
+     * @retval >=0 受信データ
+     * @retval <0 受信データ無し
+     *
+     * サーバーから受信します。
+     * 受信データが無いときは負の値を返します。
+     */
+    virtual int read(void)
+    {
+        if (!Connected_)
+            return -1;
+
+        if (ReceiveBuffer_.empty() && available() <= 0)
+            return -1;
+
+        const uint8_t data = ReceiveBuffer_.front();
+        ReceiveBuffer_.pop();
+
+        return data;
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーから受信
+     *
+     * @param [in,out] buf データ。
+     * @param [in] size データサイズ。
+     * @retval >=0 受信したデータサイズ
+     * @retval <0 エラー
+     *
+     * サーバーから受信します。
+     * エラーのときは負の値を返します。
+     */
+    virtual int read(uint8_t *buf, size_t size)
+    {
+        if (!Connected_)
+            return -1;
+
+        if (ReceiveBuffer_.size() < size && available() < 0)
+            return -1;
+
+        return ReceiveBuffer_.pop(buf, size);
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーから先読み受信
+     *
+     * @retval >=0 受信データ
+     * @retval <0 受信データ無し
+     *
+     * サーバーから受信したデータを先読みします。
+     * 受信データが無いときは負の値を返します。
+     */
+    virtual int peek(void)
+    {
+        if (!Connected_)
+            return -1;
+
+        if (ReceiveBuffer_.empty() && available() <= 0)
+            return -1;
+
+        return ReceiveBuffer_.front();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信データを破棄
+     *
+     * サーバーから受信したデータを破棄します。
+     */
+    virtual void flush(void)
+    {
+        if (!Connected_)
+            return;
+
+        available();
+
+        ReceiveBuffer_.clear();
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーを切断
+     *
+     * サーバーを切断します。
+     */
+    virtual void stop(void)
+    {
+        if (!Connected_)
+            return;
+
+        derived().closeModuleSocket();
+
+        ReceiveBuffer_.clear();
+        ModuleReceivePending_ = false;
+
+        Connected_ = false;
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーの接続状態を取得
+     *
+     * @retval 1 接続
+     * @retval 0 切断
+     *
+     * サーバーの接続状態を取得します。
+     * リモートから切断されても、未読のデータがある間は接続として扱います。
+     */
+    virtual uint8_t connected(void)
+    {
+        if (!Connected_)
+            return 0;
+
+        // Closed by remote and all received data has been read
+        if (derived().isModuleSocketClosedNotified() && ReceiveBuffer_.empty() && !ModuleReceivePending_ && !derived().isModuleSocketReceiveNotified())
+            return 0;
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief サーバーの接続状態を取得
+     *
+     * @retval 1 接続
+     * @retval 0 切断
+     *
+     * サーバーの接続状態を取得します。
+     */
+    virtual operator bool(void)
+    {
+        return connected();
+    }
+};
+
+#endif // WIOCELLULARSOCKETCLIENT_HPP
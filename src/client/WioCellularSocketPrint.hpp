@@ -0,0 +1,176 @@
+/*
+ * WioCellularSocketPrint.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARSOCKETPRINT_HPP
+#define WIOCELLULARSOCKETPRINT_HPP
+
+#include "../WioCellular.hpp"
+#include <Print.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+/**
+ * @~Japanese
+ * @brief ソケットへ出力するPrint
+ *
+ * @tparam MODULE モジュールのクラス
+ *
+ * 書き込んだデータを固定サイズのバッファに溜めて、バッファが一杯になる度にAT+QISENDで送信するPrintのクラスです。
+ * serializeJson()などのPrintへ出力する関数から、std::stringを経由せずにソケットへ送信できます。
+ * 最後にflush()を呼び出して、バッファに残ったデータを送信してください。
+ * 送信に失敗したときはgetWriteError()が0以外になり、以降の書き込みを破棄します。
+ */
+template <typename MODULE>
+class WioCellularSocketPrint : public Print
+{
+public:
+    /**
+     * @~Japanese
+     * @brief 1回のAT+QISENDで送信する最大サイズ[バイト]
+     */
+    static constexpr size_t CHUNK_SIZE = 1460;
+
+private:
+    MODULE &Module_;
+    int ConnectId_;
+    size_t Used_;
+    size_t SentSize_;
+    std::array<uint8_t, CHUNK_SIZE> Buffer_;
+
+    bool sendBuffer(void)
+    {
+        if (Used_ == 0)
+            return true;
+
+        if (Module_.sendSocket(ConnectId_, Buffer_.data(), Used_) != WioCellularResult::Ok)
+        {
+            setWriteError();
+            Used_ = 0;
+            return false;
+        }
+        SentSize_ += Used_;
+        Used_ = 0;
+
+        return true;
+    }
+
+public:
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] connectId 接続ID。オープン済みのソケット。
+     *
+     * コンストラクタ。
+     */
+    WioCellularSocketPrint(MODULE &module, int connectId) : Module_{module},
+                                                             ConnectId_{connectId},
+                                                             Used_{0},
+                                                             SentSize_{0},
+                                                             Buffer_{}
+    {
+    }
+
+    /**
+     * @~Japanese
+     * @brief デストラクタ
+     *
+     * バッファに残ったデータを送信します。
+     */
+    virtual ~WioCellularSocketPrint(void)
+    {
+        flush();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 書き込み
+     *
+     * @param [in] data データ。
+     * @return 書き込んだデータサイズ。
+     *
+     * バッファへ書き込みます。
+     */
+    virtual size_t write(uint8_t data)
+    {
+        return write(&data, 1);
+    }
+
+    /**
+     * @~Japanese
+     * @brief 書き込み
+     *
+     * @param [in] buffer データ。
+     * @param [in] size データサイズ。
+     * @return 書き込んだデータサイズ。
+     *
+     * バッファへ書き込みます。
+     * バッファが一杯になったら送信します。
+     */
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        if (getWriteError())
+            return 0;
+
+        size_t written = 0;
+        while (written < size)
+        {
+            const auto copySize = std::min(size - written, Buffer_.size() - Used_);
+            memcpy(&Buffer_[Used_], &buffer[written], copySize);
+            Used_ += copySize;
+            written += copySize;
+
+            if (Used_ >= Buffer_.size() && !sendBuffer())
+                return 0;
+        }
+
+        return written;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 書き込み可能なサイズを取得
+     *
+     * @return 送信せずに書き込めるサイズ。
+     *
+     * バッファの空きサイズを取得します。
+     */
+    virtual int availableForWrite(void)
+    {
+        return Buffer_.size() - Used_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信
+     *
+     * バッファに残ったデータを送信します。
+     */
+    virtual void flush(void)
+    {
+        if (getWriteError())
+            return;
+
+        sendBuffer();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信したデータサイズを取得
+     *
+     * @return 送信したデータサイズ。
+     *
+     * 送信したデータサイズを取得します。バッファに残っているデータは含みません。
+     */
+    size_t getSentSize(void) const
+    {
+        return SentSize_;
+    }
+};
+
+#endif // WIOCELLULARSOCKETPRINT_HPP
@@ -0,0 +1,93 @@
+/*
+ * WioCellularSslClient.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARSSLCLIENT_HPP
+#define WIOCELLULARSSLCLIENT_HPP
+
+#include "WioCellularSocketClient.hpp"
+
+/**
+ * @~Japanese
+ * @brief SSLクライアント
+ *
+ * @tparam MODULE モジュールのクラス
+ *
+ * SSLクライアントのクラスです。
+ * TLSの処理はモジュールで行います。
+ * 接続する前に、SSLコンテキストをモジュールのsetSslVersion()やsetSslCertificate()などで設定してください。
+ * setSslSessionResumption()でセッション再開を有効にすると、stop()した後の再接続でフルハンドシェイクを省略できます。
+ */
+template <typename MODULE>
+class WioCellularSslClient : public WioCellularSocketClient<WioCellularSslClient<MODULE>, MODULE>
+{
+    friend class WioCellularSocketClient<WioCellularSslClient<MODULE>, MODULE>;
+
+protected:
+    int SslContextId_;
+    int ClientId_;
+
+    WioCellularResult openModuleSocket(const char *host, uint16_t port)
+    {
+        return this->Module_.openSslSocket(this->PdpContextId_, SslContextId_, ClientId_, host, port);
+    }
+
+    WioCellularResult sendModuleSocket(const void *data, size_t dataSize)
+    {
+        return this->Module_.sendSslSocket(ClientId_, data, dataSize);
+    }
+
+    WioCellularResult receiveModuleSocket(void *data, size_t dataSize, size_t *receivedDataSize)
+    {
+        return this->Module_.receiveSslSocket(ClientId_, data, dataSize, receivedDataSize);
+    }
+
+    WioCellularResult closeModuleSocket(void)
+    {
+        return this->Module_.closeSslSocket(ClientId_);
+    }
+
+    bool isModuleSocketReceiveNotified(void)
+    {
+        return this->Module_.isSslSocketReceiveNotified(ClientId_);
+    }
+
+    bool isModuleSocketClosedNotified(void)
+    {
+        return this->Module_.isSslSocketClosedNotified(ClientId_);
+    }
+
+public:
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] pdpContextId PDPコンテキスト。
+     * @param [in] sslContextId SSLコンテキストID。
+     * @param [in] clientId クライアントID。
+     *
+     * コンストラクタ。
+     */
+    WioCellularSslClient(MODULE &module, int pdpContextId, int sslContextId, int clientId) : WioCellularSocketClient<WioCellularSslClient<MODULE>, MODULE>{module, pdpContextId},
+                                                                                             SslContextId_{sslContextId},
+                                                                                             ClientId_{clientId}
+    {
+    }
+
+    /**
+     * @~Japanese
+     * @brief デストラクタ
+     *
+     * デストラクタ。
+     */
+    virtual ~WioCellularSslClient(void)
+    {
+        if (this->Connected_)
+            this->stop();
+    }
+};
+
+#endif // WIOCELLULARSSLCLIENT_HPP
@@ -0,0 +1,157 @@
+/*
+ * WioCellularTcpServer.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARTCPSERVER_HPP
+#define WIOCELLULARTCPSERVER_HPP
+
+#include "../WioCellular.hpp"
+#include "WioCellularTcpClient.hpp"
+
+/**
+ * @~Japanese
+ * @brief TCPサーバー
+ *
+ * @tparam MODULE モジュールのクラス
+ *
+ * TCPサーバーのクラスです。
+ * サービスタイプ"TCP LISTENER"のソケットで接続を待ち受け、受け付けた接続をWioCellularTcpClientに割り当てます。
+ */
+template <typename MODULE>
+class WioCellularTcpServer
+{
+protected:
+    MODULE &Module_;
+    int PdpContextId_;
+    int ConnectId_;
+    uint16_t Port_;
+    bool Listening_;
+
+public:
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] pdpContextId PDPコンテキスト。
+     * @param [in] connectId 待ち受けに使う接続ID。
+     * @param [in] port 待ち受けるポート番号。
+     *
+     * コンストラクタ。
+     */
+    WioCellularTcpServer(MODULE &module, int pdpContextId, int connectId, uint16_t port) : Module_{module},
+                                                                                           PdpContextId_{pdpContextId},
+                                                                                           ConnectId_{connectId},
+                                                                                           Port_{port},
+                                                                                           Listening_{false}
+    {
+    }
+
+    /**
+     * @~Japanese
+     * @brief デストラクタ
+     *
+     * デストラクタ。
+     */
+    virtual ~WioCellularTcpServer(void)
+    {
+        if (Listening_)
+            end();
+    }
+
+    /**
+     * @~Japanese
+     * @brief 待ち受けを開始
+     *
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * TCPの待ち受けを開始します。
+     */
+    virtual int begin(void)
+    {
+        if (Listening_)
+            return 0;
+
+        if (Module_.openSocket(PdpContextId_, ConnectId_, "TCP LISTENER", "127.0.0.1", 0, Port_) != WioCellularResult::Ok)
+            return 0;
+
+        Listening_ = true;
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 待ち受けを終了
+     *
+     * TCPの待ち受けを終了します。
+     * 受け付け済みの接続はクローズしません。
+     */
+    virtual void end(void)
+    {
+        if (!Listening_)
+            return;
+
+        Module_.closeSocket(ConnectId_);
+
+        Listening_ = false;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 接続を受け付け
+     *
+     * @param [in,out] client 接続を割り当てるTCPクライアント。未接続である必要があります。
+     * @param [out] incoming 受け付けた接続の情報。nullptrを指定すると値を代入しません。
+     * @retval 1 受け付けた
+     * @retval 0 受け付けた接続が無い、もしくはエラー
+     *
+     * 受け付け待ちの接続を1つ取り出して、clientに割り当てます。
+     * clientがリモートから切断された接続を持ったままのときは、先にその接続をクローズします。
+     * 受け付け待ちの接続が無いときは、URCの処理を行うだけで、ATコマンドは送信しません。
+     */
+    virtual int accept(WioCellularTcpClient<MODULE> &client, typename MODULE::SocketIncoming *incoming = nullptr)
+    {
+        if (!Listening_ || client.connected())
+            return 0;
+
+        Module_.doWork(0); // Process pending URCs without sending AT command
+
+        typename MODULE::SocketIncoming newIncoming;
+        if (!Module_.acceptSocket(ConnectId_, &newIncoming))
+            return 0;
+
+        // Release the socket of a connection closed by remote
+        client.stop();
+
+        if (!client.attach(newIncoming.connectId))
+        {
+            Module_.closeSocket(newIncoming.connectId);
+            return 0;
+        }
+
+        if (incoming)
+            *incoming = newIncoming;
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 待ち受け状態を取得
+     *
+     * @retval true 待ち受け中
+     * @retval false 停止
+     *
+     * 待ち受け状態を取得します。
+     */
+    virtual operator bool(void)
+    {
+        return Listening_;
+    }
+};
+
+#endif // WIOCELLULARTCPSERVER_HPP
@@ -0,0 +1,407 @@
+/*
+ * WioCellularUdpClient.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef WIOCELLULARUDPCLIENT_HPP
+#define WIOCELLULARUDPCLIENT_HPP
+
+#include "../WioCellular.hpp"
+#include <Udp.h>
+#include <array>
+
+/**
+ * @~Japanese
+ * @brief UDPクライアント
+ *
+ * @tparam MODULE モジュールのクラス
+ *
+ * UDPクライアントのクラスです。
+ * サービスタイプ"UDP SERVICE"のソケットを使い、データグラム単位で送受信します。
+ */
+template <typename MODULE>
+class WioCellularUdpClient : public UDP
+{
+public:
+    /**
+     * @~Japanese
+     * @brief 送信する最大バイト数
+     */
+    static constexpr size_t SEND_MAX_LENGTH = 1460;
+    /**
+     * @~Japanese
+     * @brief 受信する最大バイト数
+     */
+    static constexpr size_t RECEIVE_MAX_LENGTH = 1500;
+
+protected:
+    MODULE &Module_;
+    int PdpContextId_;
+    int ConnectId_;
+    bool Opened_;
+    bool ModuleReceivePending_; // There may be unread datagrams in the module
+
+    std::string SendRemoteIpAddress_;
+    int SendRemotePort_;
+    bool SendStarted_;
+    size_t SendSize_;
+    std::array<uint8_t, SEND_MAX_LENGTH> SendBuffer_;
+
+    std::string ReceiveRemoteIpAddress_;
+    int ReceiveRemotePort_;
+    size_t ReceiveSize_;
+    size_t ReceivePosition_;
+    std::array<uint8_t, RECEIVE_MAX_LENGTH> ReceiveBuffer_;
+
+public:
+    /**
+     * @~Japanese
+     * @brief コンストラクタ
+     *
+     * @param [in] module モジュールのインスタンス。
+     * @param [in] pdpContextId PDPコンテキスト。
+     * @param [in] connectId 接続ID。
+     *
+     * コンストラクタ。
+     */
+    WioCellularUdpClient(MODULE &module, int pdpContextId, int connectId) : Module_{module},
+                                                                            PdpContextId_{pdpContextId},
+                                                                            ConnectId_{connectId},
+                                                                            Opened_{false},
+                                                                            ModuleReceivePending_{false},
+                                                                            SendRemoteIpAddress_{},
+                                                                            SendRemotePort_{0},
+                                                                            SendStarted_{false},
+                                                                            SendSize_{0},
+                                                                            SendBuffer_{},
+                                                                            ReceiveRemoteIpAddress_{},
+                                                                            ReceiveRemotePort_{0},
+                                                                            ReceiveSize_{0},
+                                                                            ReceivePosition_{0},
+                                                                            ReceiveBuffer_{}
+    {
+    }
+
+    /**
+     * @~Japanese
+     * @brief デストラクタ
+     *
+     * デストラクタ。
+     */
+    virtual ~WioCellularUdpClient(void)
+    {
+        if (Opened_)
+            stop();
+    }
+
+    /**
+     * @~Japanese
+     * @brief UDPを開始
+     *
+     * @param [in] port ローカルポート番号。
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * ローカルポート番号でUDPソケットをオープンします。
+     */
+    virtual uint8_t begin(uint16_t port)
+    {
+        if (Opened_)
+            return 0;
+
+        if (Module_.openSocket(PdpContextId_, ConnectId_, "UDP SERVICE", "127.0.0.1", 0, port) != WioCellularResult::Ok)
+            return 0;
+
+        Opened_ = true;
+        ModuleReceivePending_ = false;
+        SendStarted_ = false;
+        ReceiveSize_ = 0;
+        ReceivePosition_ = 0;
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief UDPを終了
+     *
+     * UDPソケットをクローズします。
+     */
+    virtual void stop(void)
+    {
+        if (!Opened_)
+            return;
+
+        Module_.closeSocket(ConnectId_);
+
+        SendStarted_ = false;
+        ReceiveSize_ = 0;
+        ReceivePosition_ = 0;
+        Opened_ = false;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信パケットを開始
+     *
+     * @param [in] ip 宛先のIPアドレス。
+     * @param [in] port 宛先のポート番号。
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * 送信パケットの組み立てを開始します。
+     */
+    virtual int beginPacket(IPAddress ip, uint16_t port)
+    {
+        String ipStr = String(ip[0]);
+        ipStr += ".";
+        ipStr += String(ip[1]);
+        ipStr += ".";
+        ipStr += String(ip[2]);
+        ipStr += ".";
+        ipStr += String(ip[3]);
+
+        return beginPacket(ipStr.c_str(), port);
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信パケットを開始
+     *
+     * @param [in] host 宛先のIPアドレス文字列。
+     * @param [in] port 宛先のポート番号。
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * 送信パケットの組み立てを開始します。
+     */
+    virtual int beginPacket(const char *host, uint16_t port)
+    {
+        if (!Opened_)
+            return 0;
+
+        SendRemoteIpAddress_ = host;
+        SendRemotePort_ = port;
+        SendStarted_ = true;
+        SendSize_ = 0;
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信パケットを終了
+     *
+     * @retval 1 成功
+     * @retval 0 エラー
+     *
+     * 組み立てたパケットを1データグラムとして送信します。
+     */
+    virtual int endPacket(void)
+    {
+        if (!Opened_ || !SendStarted_)
+            return 0;
+
+        SendStarted_ = false;
+        if (Module_.sendSocket(ConnectId_, SendRemoteIpAddress_, SendRemotePort_, SendBuffer_.data(), SendSize_) != WioCellularResult::Ok)
+            return 0;
+
+        return 1;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信パケットへ書き込み
+     *
+     * @param [in] data データ。
+     * @return 書き込んだデータサイズ。
+     *
+     * 送信パケットへ書き込みます。
+     */
+    virtual size_t write(uint8_t data)
+    {
+        return write(&data, 1);
+    }
+
+    /**
+     * @~Japanese
+     * @brief 送信パケットへ書き込み
+     *
+     * @param [in] buffer データ。
+     * @param [in] size データサイズ。
+     * @return 書き込んだデータサイズ。
+     *
+     * 送信パケットへ書き込みます。
+     * SEND_MAX_LENGTHを超えた分は書き込みません。
+     */
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        if (!SendStarted_)
+            return 0;
+
+        if (size > SendBuffer_.size() - SendSize_)
+            size = SendBuffer_.size() - SendSize_;
+        memcpy(&SendBuffer_[SendSize_], buffer, size);
+        SendSize_ += size;
+
+        return size;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットを確認
+     *
+     * @return 受信パケットのサイズ。受信パケットが無いときは0。
+     *
+     * 次の受信パケットを読み込みます。
+     * 前の受信パケットの未読データは破棄します。
+     * 受信通知のURCがあったとき、もしくはモジュール内に未読のデータグラムが残っているときだけモジュールへ問い合わせます。
+     */
+    virtual int parsePacket(void)
+    {
+        ReceiveSize_ = 0;
+        ReceivePosition_ = 0;
+
+        if (!Opened_)
+            return 0;
+
+        Module_.doWork(0); // Process pending URCs without sending AT command
+        if (!ModuleReceivePending_ && !Module_.isSocketReceiveNotified(ConnectId_))
+            return 0;
+
+        size_t size;
+        if (Module_.receiveSocket(ConnectId_, ReceiveBuffer_.data(), ReceiveBuffer_.size(), &size, &ReceiveRemoteIpAddress_, &ReceiveRemotePort_) != WioCellularResult::Ok)
+            return 0;
+
+        // The module does not notify again until its buffer has been read dry.
+        ModuleReceivePending_ = size >= 1;
+        ReceiveSize_ = size;
+
+        return ReceiveSize_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットの未読データサイズを取得
+     *
+     * @return 未読のデータサイズ。
+     *
+     * 受信パケットの未読データサイズを取得します。
+     */
+    virtual int available(void)
+    {
+        return ReceiveSize_ - ReceivePosition_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットから読み込み
+     *
+     * @retval >=0 受信データ
+     * @retval <0 受信データ無し
+     *
+     * 受信パケットから読み込みます。
+     */
+    virtual int read(void)
+    {
+        if (ReceivePosition_ >= ReceiveSize_)
+            return -1;
+
+        return ReceiveBuffer_[ReceivePosition_++];
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットから読み込み
+     *
+     * @param [in,out] buffer データ。
+     * @param [in] len データサイズ。
+     * @return 読み込んだデータサイズ。
+     *
+     * 受信パケットから読み込みます。
+     * 受信パケットの境界を越えて読み込むことはありません。
+     */
+    virtual int read(unsigned char *buffer, size_t len)
+    {
+        const size_t size = std::min(len, ReceiveSize_ - ReceivePosition_);
+        memcpy(buffer, &ReceiveBuffer_[ReceivePosition_], size);
+        ReceivePosition_ += size;
+
+        return size;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットから読み込み
+     *
+     * @param [in,out] buffer データ。
+     * @param [in] len データサイズ。
+     * @return 読み込んだデータサイズ。
+     *
+     * 受信パケットから読み込みます。
+     */
+    virtual int read(char *buffer, size_t len)
+    {
+        return read(reinterpret_cast<unsigned char *>(buffer), len);
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットから先読み
+     *
+     * @retval >=0 受信データ
+     * @retval <0 受信データ無し
+     *
+     * 受信パケットから先読みします。
+     */
+    virtual int peek(void)
+    {
+        if (ReceivePosition_ >= ReceiveSize_)
+            return -1;
+
+        return ReceiveBuffer_[ReceivePosition_];
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットを破棄
+     *
+     * 受信パケットの未読データを破棄します。
+     */
+    virtual void flush(void)
+    {
+        ReceivePosition_ = ReceiveSize_;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットの送信元IPアドレスを取得
+     *
+     * @return 送信元のIPアドレス。
+     *
+     * 受信パケットの送信元IPアドレスを取得します。
+     */
+    virtual IPAddress remoteIP(void)
+    {
+        IPAddress ip;
+        ip.fromString(ReceiveRemoteIpAddress_.c_str());
+
+        return ip;
+    }
+
+    /**
+     * @~Japanese
+     * @brief 受信パケットの送信元ポート番号を取得
+     *
+     * @return 送信元のポート番号。
+     *
+     * 受信パケットの送信元ポート番号を取得します。
+     */
+    virtual uint16_t remotePort(void)
+    {
+        return ReceiveRemotePort_;
+    }
+};
+
+#endif // WIOCELLULARUDPCLIENT_HPP
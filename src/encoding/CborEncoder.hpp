@@ -0,0 +1,479 @@
+/*
+ * CborEncoder.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef CBORENCODER_HPP
+#define CBORENCODER_HPP
+
+#include <Print.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace wiocellular
+{
+    namespace encoding
+    {
+
+        /**
+         * @~Japanese
+         * @brief CBORエンコーダー
+         *
+         * CBOR(RFC 8949)でエンコードするクラスです。
+         * 呼び出し元のバッファ、もしくはPrint(WioCellularSocketPrintなど)へ直接書き込み、ヒープを使いません。
+         * 同じ内容のJSONより小さくなるので、送信するデータ量を減らせます。
+         *
+         * テレメトリー用に、小さな整数のキーを使う固定スキーマのヘルパーを用意しています。
+         * writeMap()で要素数を書いてから、writeUptime()などで要素を書き込みます。
+         * 例: encoder.writeMap(CborEncoder::UPTIME_PAIRS + CborEncoder::SIGNAL_PAIRS); encoder.writeUptime(...); encoder.writeSignal(...);
+         */
+        class CborEncoder
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief テレメトリーのキー
+             */
+            enum class TelemetryKey
+            {
+                /**
+                 * @~Japanese
+                 * @brief 起動からの時間[秒]
+                 */
+                Uptime = 0,
+                /**
+                 * @~Japanese
+                 * @brief 緯度[1e-7度]
+                 */
+                Latitude = 1,
+                /**
+                 * @~Japanese
+                 * @brief 経度[1e-7度]
+                 */
+                Longitude = 2,
+                /**
+                 * @~Japanese
+                 * @brief 高度[m]
+                 */
+                Altitude = 3,
+                /**
+                 * @~Japanese
+                 * @brief RSSI[dBm]
+                 */
+                Rssi = 4,
+                /**
+                 * @~Japanese
+                 * @brief RSRP[dBm]
+                 */
+                Rsrp = 5,
+                /**
+                 * @~Japanese
+                 * @brief RSRQ[dB]
+                 */
+                Rsrq = 6,
+                /**
+                 * @~Japanese
+                 * @brief セルID
+                 */
+                CellId = 7,
+                /**
+                 * @~Japanese
+                 * @brief TAC(tracking area code)
+                 */
+                Tac = 8,
+                /**
+                 * @~Japanese
+                 * @brief チャネル番号(EARFCN)
+                 */
+                Earfcn = 9,
+                /**
+                 * @~Japanese
+                 * @brief 物理セルID
+                 */
+                Pcid = 10,
+                /**
+                 * @~Japanese
+                 * @brief 周波数バンド
+                 */
+                Band = 11,
+            };
+
+            /**
+             * @~Japanese
+             * @brief writeUptime()が書き込む要素数
+             */
+            static constexpr size_t UPTIME_PAIRS = 1;
+            /**
+             * @~Japanese
+             * @brief writeGpsFix()が書き込む要素数
+             */
+            static constexpr size_t GPS_FIX_PAIRS = 3;
+            /**
+             * @~Japanese
+             * @brief writeSignal()が書き込む要素数
+             */
+            static constexpr size_t SIGNAL_PAIRS = 3;
+            /**
+             * @~Japanese
+             * @brief writeServingCell()が書き込む要素数
+             */
+            static constexpr size_t SERVING_CELL_PAIRS = 5;
+
+        private:
+            uint8_t *Buffer_;
+            size_t BufferSize_;
+            Print *Print_;
+            size_t Size_;
+            bool Overflow_;
+
+            void write(const uint8_t *data, size_t dataSize)
+            {
+                if (Overflow_)
+                    return;
+
+                if (Print_)
+                {
+                    if (Print_->write(data, dataSize) != dataSize)
+                        Overflow_ = true;
+                }
+                else
+                {
+                    if (Size_ + dataSize > BufferSize_)
+                    {
+                        Overflow_ = true;
+                        return;
+                    }
+                    memcpy(&Buffer_[Size_], data, dataSize);
+                }
+                Size_ += dataSize;
+            }
+
+            void writeHead(uint8_t majorType, uint64_t argument)
+            {
+                uint8_t head[9];
+                size_t headSize;
+                if (argument < 24)
+                {
+                    head[0] = majorType << 5 | argument;
+                    headSize = 1;
+                }
+                else if (argument <= 0xff)
+                {
+                    head[0] = majorType << 5 | 24;
+                    headSize = 2;
+                }
+                else if (argument <= 0xffff)
+                {
+                    head[0] = majorType << 5 | 25;
+                    headSize = 3;
+                }
+                else if (argument <= 0xffffffff)
+                {
+                    head[0] = majorType << 5 | 26;
+                    headSize = 5;
+                }
+                else
+                {
+                    head[0] = majorType << 5 | 27;
+                    headSize = 9;
+                }
+                for (size_t i = headSize - 1; i >= 1; --i)
+                {
+                    head[i] = argument & 0xff;
+                    argument >>= 8;
+                }
+                write(head, headSize);
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [out] buffer 書き込み先のバッファ。
+             * @param [in] bufferSize バッファのサイズ。
+             *
+             * バッファへ書き込むエンコーダーを作ります。
+             */
+            CborEncoder(uint8_t *buffer, size_t bufferSize) : Buffer_{buffer},
+                                                             BufferSize_{bufferSize},
+                                                             Print_{nullptr},
+                                                             Size_{0},
+                                                             Overflow_{false}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] print 書き込み先のPrint。
+             *
+             * Printへ書き込むエンコーダーを作ります。
+             */
+            explicit CborEncoder(Print &print) : Buffer_{nullptr},
+                                                 BufferSize_{0},
+                                                 Print_{&print},
+                                                 Size_{0},
+                                                 Overflow_{false}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief 書き込んだサイズを取得
+             *
+             * @return 書き込んだサイズ[バイト]。
+             *
+             * 書き込んだサイズを取得します。
+             */
+            size_t size(void) const
+            {
+                return Size_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief エラーを取得
+             *
+             * @retval true エラー無し
+             * @retval false バッファが足りないか、Printへの書き込みに失敗
+             *
+             * エラーが無いかを取得します。エラーの後の書き込みは破棄します。
+             */
+            bool ok(void) const
+            {
+                return !Overflow_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 最初から書き直す
+             *
+             * 書き込んだサイズとエラーをクリアします。
+             */
+            void clear(void)
+            {
+                Size_ = 0;
+                Overflow_ = false;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 符号無し整数を書き込み
+             *
+             * @param [in] value 値。
+             */
+            void writeUnsigned(uint64_t value)
+            {
+                writeHead(0, value);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 整数を書き込み
+             *
+             * @param [in] value 値。
+             */
+            void writeInt(int64_t value)
+            {
+                if (value >= 0)
+                    writeHead(0, static_cast<uint64_t>(value));
+                else
+                    writeHead(1, static_cast<uint64_t>(-1 - value));
+            }
+
+            /**
+             * @~Japanese
+             * @brief バイト列を書き込み
+             *
+             * @param [in] data データ。
+             * @param [in] dataSize データサイズ。
+             */
+            void writeBytes(const void *data, size_t dataSize)
+            {
+                writeHead(2, dataSize);
+                write(static_cast<const uint8_t *>(data), dataSize);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 文字列を書き込み
+             *
+             * @param [in] text UTF-8の文字列。
+             * @param [in] textSize 文字列のサイズ[バイト]。
+             */
+            void writeText(const char *text, size_t textSize)
+            {
+                writeHead(3, textSize);
+                write(reinterpret_cast<const uint8_t *>(text), textSize);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 文字列を書き込み
+             *
+             * @param [in] text UTF-8の文字列。
+             */
+            void writeText(const char *text)
+            {
+                writeText(text, strlen(text));
+            }
+
+            /**
+             * @~Japanese
+             * @brief 配列の開始を書き込み
+             *
+             * @param [in] count 要素数。
+             *
+             * 続けてcount個の値を書き込みます。
+             */
+            void writeArray(size_t count)
+            {
+                writeHead(4, count);
+            }
+
+            /**
+             * @~Japanese
+             * @brief マップの開始を書き込み
+             *
+             * @param [in] count キーと値の組の数。
+             *
+             * 続けてcount組のキーと値を書き込みます。
+             */
+            void writeMap(size_t count)
+            {
+                writeHead(5, count);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 真偽値を書き込み
+             *
+             * @param [in] value 値。
+             */
+            void writeBool(bool value)
+            {
+                const uint8_t data = value ? 0xf5 : 0xf4;
+                write(&data, 1);
+            }
+
+            /**
+             * @~Japanese
+             * @brief nullを書き込み
+             */
+            void writeNull(void)
+            {
+                const uint8_t data = 0xf6;
+                write(&data, 1);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 単精度浮動小数点数を書き込み
+             *
+             * @param [in] value 値。
+             */
+            void writeFloat(float value)
+            {
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                const uint8_t data[] = {
+                    0xfa,
+                    static_cast<uint8_t>(bits >> 24),
+                    static_cast<uint8_t>(bits >> 16),
+                    static_cast<uint8_t>(bits >> 8),
+                    static_cast<uint8_t>(bits),
+                };
+                write(data, sizeof(data));
+            }
+
+            /**
+             * @~Japanese
+             * @brief 起動からの時間を書き込み
+             *
+             * @param [in] uptime 起動からの時間[秒]。
+             *
+             * マップの要素を、UPTIME_PAIRS組書き込みます。
+             */
+            void writeUptime(uint32_t uptime)
+            {
+                writeUnsigned(static_cast<int>(TelemetryKey::Uptime));
+                writeUnsigned(uptime);
+            }
+
+            /**
+             * @~Japanese
+             * @brief GPSの測位結果を書き込み
+             *
+             * @param [in] latitude 緯度[度]。
+             * @param [in] longitude 経度[度]。
+             * @param [in] altitude 高度[m]。
+             *
+             * マップの要素を、GPS_FIX_PAIRS組書き込みます。
+             * 緯度と経度は、精度を落とさずに小さくするため1e-7度単位の整数で書き込みます。
+             */
+            void writeGpsFix(double latitude, double longitude, float altitude)
+            {
+                writeUnsigned(static_cast<int>(TelemetryKey::Latitude));
+                writeInt(static_cast<int64_t>(std::lround(latitude * 1e7)));
+                writeUnsigned(static_cast<int>(TelemetryKey::Longitude));
+                writeInt(static_cast<int64_t>(std::lround(longitude * 1e7)));
+                writeUnsigned(static_cast<int>(TelemetryKey::Altitude));
+                writeFloat(altitude);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 電波の状態を書き込み
+             *
+             * @param [in] rssi RSSI[dBm]。
+             * @param [in] rsrp RSRP[dBm]。
+             * @param [in] rsrq RSRQ[dB]。
+             *
+             * マップの要素を、SIGNAL_PAIRS組書き込みます。
+             */
+            void writeSignal(int rssi, int rsrp, int rsrq)
+            {
+                writeUnsigned(static_cast<int>(TelemetryKey::Rssi));
+                writeInt(rssi);
+                writeUnsigned(static_cast<int>(TelemetryKey::Rsrp));
+                writeInt(rsrp);
+                writeUnsigned(static_cast<int>(TelemetryKey::Rsrq));
+                writeInt(rsrq);
+            }
+
+            /**
+             * @~Japanese
+             * @brief サービングセルを書き込み
+             *
+             * @param [in] cellId セルID。
+             * @param [in] tac TAC(tracking area code)。
+             * @param [in] earfcn チャネル番号(EARFCN)。
+             * @param [in] pcid 物理セルID。
+             * @param [in] band 周波数バンド。
+             *
+             * マップの要素を、SERVING_CELL_PAIRS組書き込みます。
+             * getServingCell()で取得した値を、そのまま渡せます。
+             */
+            void writeServingCell(uint32_t cellId, uint32_t tac, int earfcn, int pcid, int band)
+            {
+                writeUnsigned(static_cast<int>(TelemetryKey::CellId));
+                writeUnsigned(cellId);
+                writeUnsigned(static_cast<int>(TelemetryKey::Tac));
+                writeUnsigned(tac);
+                writeUnsigned(static_cast<int>(TelemetryKey::Earfcn));
+                writeInt(earfcn);
+                writeUnsigned(static_cast<int>(TelemetryKey::Pcid));
+                writeInt(pcid);
+                writeUnsigned(static_cast<int>(TelemetryKey::Band));
+                writeInt(band);
+            }
+        };
+
+    }
+}
+
+#endif // CBORENCODER_HPP
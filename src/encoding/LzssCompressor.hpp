@@ -0,0 +1,290 @@
+/*
+ * LzssCompressor.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef LZSSCOMPRESSOR_HPP
+#define LZSSCOMPRESSOR_HPP
+
+#include <Print.h>
+#include <cstdint>
+#include <cstring>
+
+namespace wiocellular
+{
+    namespace encoding
+    {
+
+        /**
+         * @~Japanese
+         * @brief LZSS圧縮
+         *
+         * 書き込んだデータをLZSS(LZ77の一種)で圧縮して、別のPrintへ出力するPrintのクラスです。
+         * WioCellularSocketPrintなどを出力先にすると、圧縮しながらソケットへ送信できます。
+         * ヒープを使わず、約5KBのメモリで動作します。
+         * 最後にflush()を呼び出すと、残りのデータを出力して、次の書き込みから新しいストリームになります。
+         *
+         * 形式:
+         * - フラグ1バイトに続けて、最大8個の要素を置きます。フラグのビット0から順に、各要素の種類を表します。
+         * - ビットが0の要素はリテラル1バイトです。
+         * - ビットが1の要素は一致2バイトです。距離-1(11ビット)と長さ-3(5ビット)を、[距離-1の下位8ビット][距離-1の上位3ビット<<5|長さ-3]の順に置きます。
+         * - ストリームの終わりはデータの終わりです。
+         *
+         * ホスト側の伸長ツールはextras/tools/lzssにあります。
+         */
+        class LzssCompressor : public Print
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief 一致を探す範囲[バイト]
+             */
+            static constexpr size_t WINDOW_SIZE = 2047;
+            /**
+             * @~Japanese
+             * @brief 一致の最小長[バイト]
+             */
+            static constexpr size_t MIN_MATCH = 3;
+            /**
+             * @~Japanese
+             * @brief 一致の最大長[バイト]
+             */
+            static constexpr size_t MAX_MATCH = 34;
+
+        private:
+            static constexpr size_t BUFFER_SIZE = 4096;
+            static constexpr size_t HASH_BITS = 9;
+            static constexpr uint16_t HASH_EMPTY = 0xffff;
+
+            Print &Output_;
+            uint8_t Buffer_[BUFFER_SIZE];
+            uint16_t Head_[1 << HASH_BITS];
+            size_t Position_; // Next byte to encode
+            size_t End_;      // End of buffered data
+            uint8_t Group_[1 + 8 * 2];
+            size_t GroupSize_;
+            int GroupCount_;
+            size_t InputSize_;
+            size_t OutputSize_;
+            bool Error_;
+
+            static size_t hash(const uint8_t *data)
+            {
+                return ((data[0] << 8 ^ data[1] << 4 ^ data[2]) * 2654435761u) >> (32 - HASH_BITS) & ((1 << HASH_BITS) - 1);
+            }
+
+            void emitGroup(void)
+            {
+                if (GroupCount_ == 0)
+                    return;
+
+                if (!Error_ && Output_.write(Group_, GroupSize_) != GroupSize_)
+                    Error_ = true;
+                OutputSize_ += GroupSize_;
+                Group_[0] = 0;
+                GroupSize_ = 1;
+                GroupCount_ = 0;
+            }
+
+            void emitLiteral(uint8_t data)
+            {
+                Group_[GroupSize_++] = data;
+                if (++GroupCount_ >= 8)
+                    emitGroup();
+            }
+
+            void emitMatch(size_t distance, size_t length)
+            {
+                Group_[0] |= 1 << GroupCount_;
+                Group_[GroupSize_++] = (distance - 1) & 0xff;
+                Group_[GroupSize_++] = (distance - 1) >> 8 << 5 | (length - MIN_MATCH);
+                if (++GroupCount_ >= 8)
+                    emitGroup();
+            }
+
+            void insertHash(size_t position)
+            {
+                if (position + MIN_MATCH <= End_)
+                    Head_[hash(&Buffer_[position])] = position;
+            }
+
+            void slide(void)
+            {
+                const size_t shift = Position_ - WINDOW_SIZE;
+                memmove(Buffer_, &Buffer_[shift], End_ - shift);
+                Position_ -= shift;
+                End_ -= shift;
+                for (auto &head : Head_)
+                    head = head != HASH_EMPTY && head >= shift ? head - shift : HASH_EMPTY;
+            }
+
+            void encode(size_t lookahead)
+            {
+                while (End_ - Position_ > lookahead)
+                {
+                    size_t length = 0;
+                    size_t distance = 0;
+                    if (Position_ + MIN_MATCH <= End_)
+                    {
+                        const auto h = hash(&Buffer_[Position_]);
+                        const size_t candidate = Head_[h];
+                        Head_[h] = Position_;
+                        if (candidate != HASH_EMPTY && candidate < Position_ && Position_ - candidate <= WINDOW_SIZE)
+                        {
+                            const size_t limit = End_ - Position_ < MAX_MATCH ? End_ - Position_ : MAX_MATCH;
+                            while (length < limit && Buffer_[candidate + length] == Buffer_[Position_ + length])
+                                ++length;
+                            distance = Position_ - candidate;
+                        }
+                    }
+
+                    if (length >= MIN_MATCH)
+                    {
+                        emitMatch(distance, length);
+                        for (size_t i = 1; i < length; ++i)
+                            insertHash(Position_ + i);
+                        Position_ += length;
+                    }
+                    else
+                    {
+                        emitLiteral(Buffer_[Position_]);
+                        ++Position_;
+                    }
+                }
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] output 圧縮したデータの出力先。
+             *
+             * コンストラクタ。
+             */
+            explicit LzssCompressor(Print &output) : Output_{output}
+            {
+                reset();
+            }
+
+            /**
+             * @~Japanese
+             * @brief 新しいストリームを開始
+             *
+             * 出力していないデータを破棄して、新しいストリームを開始します。
+             */
+            void reset(void)
+            {
+                for (auto &head : Head_)
+                    head = HASH_EMPTY;
+                Position_ = 0;
+                End_ = 0;
+                Group_[0] = 0;
+                GroupSize_ = 1;
+                GroupCount_ = 0;
+                InputSize_ = 0;
+                OutputSize_ = 0;
+                Error_ = false;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 書き込み
+             *
+             * @param [in] data データ。
+             * @return 書き込んだデータサイズ。
+             */
+            virtual size_t write(uint8_t data)
+            {
+                return write(&data, 1);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 書き込み
+             *
+             * @param [in] buffer データ。
+             * @param [in] size データサイズ。
+             * @return 書き込んだデータサイズ。
+             *
+             * データを圧縮します。一致を探すために、最後のMAX_MATCHバイトはflush()まで出力しません。
+             */
+            virtual size_t write(const uint8_t *buffer, size_t size)
+            {
+                size_t written = 0;
+                while (written < size)
+                {
+                    if (End_ >= BUFFER_SIZE)
+                        slide();
+
+                    const size_t copySize = size - written < BUFFER_SIZE - End_ ? size - written : BUFFER_SIZE - End_;
+                    memcpy(&Buffer_[End_], &buffer[written], copySize);
+                    End_ += copySize;
+                    written += copySize;
+
+                    encode(MAX_MATCH);
+                }
+                InputSize_ += size;
+
+                return Error_ ? 0 : size;
+            }
+
+            /**
+             * @~Japanese
+             * @brief ストリームを終了
+             *
+             * 残りのデータを圧縮して出力し、出力先のflush()を呼び出します。
+             * 次の書き込みから新しいストリームになります。
+             */
+            virtual void flush(void)
+            {
+                encode(0);
+                emitGroup();
+                Output_.flush();
+
+                for (auto &head : Head_)
+                    head = HASH_EMPTY;
+                Position_ = 0;
+                End_ = 0;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 入力したデータサイズを取得
+             *
+             * @return 前回のreset()からの入力サイズ[バイト]。
+             */
+            size_t getInputSize(void) const
+            {
+                return InputSize_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 出力したデータサイズを取得
+             *
+             * @return 前回のreset()からの出力サイズ[バイト]。
+             */
+            size_t getOutputSize(void) const
+            {
+                return OutputSize_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief エラーを取得
+             *
+             * @retval true エラー無し
+             * @retval false 出力先への書き込みに失敗
+             */
+            bool ok(void) const
+            {
+                return !Error_;
+            }
+        };
+
+    }
+}
+
+#endif // LZSSCOMPRESSOR_HPP
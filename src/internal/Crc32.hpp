@@ -0,0 +1,39 @@
+/*
+ * Crc32.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef CRC32_HPP
+#define CRC32_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wiocellular
+{
+    namespace internal
+    {
+
+        // CRC-32 (IEEE 802.3, reflected polynomial 0xedb88320)
+        // Pass the previous return value as crc to continue over multiple blocks.
+        static uint32_t crc32(const void *data, size_t size, uint32_t crc = 0)
+        {
+            auto p = static_cast<const uint8_t *>(data);
+
+            crc = ~crc;
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc ^= p[i];
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc = crc & 1 ? crc >> 1 ^ 0xedb88320 : crc >> 1;
+                }
+            }
+            return ~crc;
+        }
+
+    }
+}
+
+#endif // CRC32_HPP
@@ -9,6 +9,7 @@
 
 #include <cstdio>
 #include <string>
+#include <type_traits>
 
 namespace wiocellular
 {
@@ -28,6 +29,8 @@ namespace wiocellular
         template <typename T>
         static bool stringStartsWith(const std::string &str, const T &prefix, std::string *rest = nullptr)
         {
+            static_assert(std::is_array<T>::value, "prefix must be a string literal");
+
             const auto prefixLen = sizeof(prefix) - 1;
 
             if (str.compare(0, prefixLen, prefix) == 0)
@@ -44,6 +47,22 @@ namespace wiocellular
             }
         }
 
+        static bool stringStartsWith(const std::string &str, const std::string &prefix, std::string *rest = nullptr)
+        {
+            if (str.compare(0, prefix.size(), prefix) == 0)
+            {
+                if (rest)
+                {
+                    *rest = str.substr(prefix.size());
+                }
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
     }
 }
 
@@ -0,0 +1,146 @@
+/*
+ * RingBuffer.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef RINGBUFFER_HPP
+#define RINGBUFFER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace wiocellular
+{
+    namespace internal
+    {
+
+        template <typename T, size_t N>
+        class RingBuffer
+        {
+            static_assert(N >= 1, "N must be greater than 0");
+
+        private:
+            std::array<T, N> Buffer_;
+            size_t Head_; // Read position
+            size_t Size_;
+
+        public:
+            RingBuffer(void) : Buffer_{},
+                               Head_{0},
+                               Size_{0}
+            {
+            }
+
+            static constexpr size_t capacity(void)
+            {
+                return N;
+            }
+
+            size_t size(void) const
+            {
+                return Size_;
+            }
+
+            size_t freeSize(void) const
+            {
+                return N - Size_;
+            }
+
+            bool empty(void) const
+            {
+                return Size_ == 0;
+            }
+
+            bool full(void) const
+            {
+                return Size_ == N;
+            }
+
+            void clear(void)
+            {
+                Head_ = 0;
+                Size_ = 0;
+            }
+
+            const T &front(void) const
+            {
+                assert(!empty());
+
+                return Buffer_[Head_];
+            }
+
+            void pop(void)
+            {
+                assert(!empty());
+
+                Head_ = (Head_ + 1) % N;
+                if (--Size_ == 0)
+                    Head_ = 0;
+            }
+
+            // Copies up to size elements into data (nullptr to discard) and returns the number of elements popped.
+            size_t pop(T *data, size_t size)
+            {
+                if (size > Size_)
+                    size = Size_;
+
+                const size_t first = std::min(size, N - Head_);
+                if (data)
+                {
+                    memcpy(data, &Buffer_[Head_], first * sizeof(T));
+                    memcpy(data + first, &Buffer_[0], (size - first) * sizeof(T));
+                }
+
+                Head_ = (Head_ + size) % N;
+                if ((Size_ -= size) == 0)
+                    Head_ = 0;
+
+                return size;
+            }
+
+            // Returns the contiguous free region so that the producer can write directly into it, followed by commit().
+            T *writableRegion(size_t *size)
+            {
+                assert(size);
+
+                const size_t tail = (Head_ + Size_) % N;
+                *size = full() ? 0 : tail >= Head_ ? N - tail
+                                                   : Head_ - tail;
+                return &Buffer_[tail];
+            }
+
+            void commit(size_t size)
+            {
+                assert(size <= freeSize());
+
+                Size_ += size;
+            }
+
+            size_t push(const T *data, size_t size)
+            {
+                assert(data);
+
+                size_t pushed = 0;
+                while (pushed < size)
+                {
+                    size_t regionSize;
+                    T *region = writableRegion(&regionSize);
+                    if (regionSize == 0)
+                        break;
+                    const size_t n = std::min(regionSize, size - pushed);
+                    memcpy(region, data + pushed, n * sizeof(T));
+                    commit(n);
+                    pushed += n;
+                }
+
+                return pushed;
+            }
+        };
+
+    }
+}
+
+#endif // RINGBUFFER_HPP
@@ -53,6 +53,7 @@ namespace wiocellular
                     static_cast<MODULE &>(*this).getInterface().write(S3);
                 }
 
+            protected:
                 bool processingUrc(const std::string &response)
                 {
                     for (const auto &handler : UrcHandlers_)
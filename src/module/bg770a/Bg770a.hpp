@@ -8,10 +8,14 @@
 #define BG770A_HPP
 
 #include "commands/Bg770aExtendedConfigurationCommands.hpp"
+#include "commands/Bg770aFileCommands.hpp"
 #include "commands/Bg770aGeneralCommands.hpp"
+#include "commands/Bg770aHttpCommands.hpp"
+#include "commands/Bg770aMqttCommands.hpp"
 #include "commands/Bg770aNetworkServiceCommands.hpp"
 #include "commands/Bg770aPacketDomainCommands.hpp"
 #include "commands/Bg770aSimRelatedCommands.hpp"
+#include "commands/Bg770aSslCommands.hpp"
 #include "commands/Bg770aTcpipCommands.hpp"
 
 #include "module/at_client/AtClient.hpp"
@@ -36,10 +40,14 @@ namespace wiocellular
             template <typename INTERFACE>
             class Bg770a : public at_client::AtClient<Bg770a<INTERFACE>>,
                            public commands::Bg770aExtendedConfigurationCommands<Bg770a<INTERFACE>>,
+                           public commands::Bg770aFileCommands<Bg770a<INTERFACE>>,
                            public commands::Bg770aGeneralCommands<Bg770a<INTERFACE>>,
+                           public commands::Bg770aHttpCommands<Bg770a<INTERFACE>>,
+                           public commands::Bg770aMqttCommands<Bg770a<INTERFACE>>,
                            public commands::Bg770aNetworkServiceCommands<Bg770a<INTERFACE>>,
                            public commands::Bg770aPacketDomainCommands<Bg770a<INTERFACE>>,
                            public commands::Bg770aSimRelatedCommands<Bg770a<INTERFACE>>,
+                           public commands::Bg770aSslCommands<Bg770a<INTERFACE>>,
                            public commands::Bg770aTcpipCommands<Bg770a<INTERFACE>>
             {
                 friend class at_client::AtClient<Bg770a<INTERFACE>>;
@@ -243,6 +251,71 @@ namespace wiocellular
                     return WioCellularResult::Ok;
                 }
 
+                /**
+                 * @~Japanese
+                 * @brief プロンプト付きコマンドを実行
+                 *
+                 * @param [in] command コマンド。
+                 * @param [in] informationTextHandler information textのハンドラ。
+                 * @param [in] timeout タイムアウト時間[ミリ秒]。
+                 * @return 実行結果。
+                 *
+                 * プロンプト"> "の後にデータを書き込むコマンドを実行します。
+                 * プロンプトとinformaton textを読み込んだときはinformationTextHandlerを呼び出します。
+                 * sendCommand()と異なり、final result codeは"OK"です。
+                 */
+                WioCellularResult promptCommand(const std::string &command, std::function<bool(const std::string &response)> informationTextHandler, int timeout)
+                {
+                    printf("CMD> %s\n", command.c_str());
+                    const auto start = millis();
+                    if (!at_client::AtClient<Bg770a<INTERFACE>>::writeAndWaitCommand(command, COMMAND_ECHO_TIMEOUT))
+                    {
+                        return WioCellularResult::WaitCommandTimeout;
+                    }
+                    printf("ECO> %s ... %lu[ms]\n", command.c_str(), millis() - start);
+
+                    std::string response;
+                    while (true)
+                    {
+                        if ((response = at_client::AtClient<Bg770a<INTERFACE>>::readResponse(timeout, [](const std::string &response) -> bool
+                                                                                             { return response == "> "; }))
+                                .empty())
+                        {
+                            return WioCellularResult::ReadResponseTimeout;
+                        }
+
+                        // Final Result Code
+                        if (response == "OK")
+                        {
+                            printf("FRC> %s\n", response.c_str());
+                            break;
+                        }
+                        if (response == "ERROR" || internal::stringStartsWith(response, "+CME ERROR: ") || internal::stringStartsWith(response, "+CMS ERROR: "))
+                        {
+                            printf("FRC> %s\n", response.c_str());
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        // Information text
+                        if (informationTextHandler && informationTextHandler(response))
+                        {
+                            printf("INF> %s\n", response.c_str());
+                            continue;
+                        }
+
+                        // URCs for earlier commands (e.g. +QMTPUB) arrive between the prompt and OK
+                        if (at_client::AtClient<Bg770a<INTERFACE>>::processingUrc(response))
+                        {
+                            continue;
+                        }
+
+                        // Unknown
+                        printf("unk> %s\n", response.c_str());
+                    }
+
+                    return WioCellularResult::Ok;
+                }
+
                 /**
                  * @~Japanese
                  * @brief 電源をオン
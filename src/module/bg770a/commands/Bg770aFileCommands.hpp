@@ -0,0 +1,556 @@
+/*
+ * Bg770aFileCommands.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef BG770AFILECOMMANDS_HPP
+#define BG770AFILECOMMANDS_HPP
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "module/at_client/AtParameterParser.hpp"
+#include "internal/Misc.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace module
+    {
+        namespace bg770a
+        {
+            namespace commands
+            {
+
+                /**
+                 * @~Japanese
+                 * @brief Quectel BG770Aモジュールのファイルコマンド
+                 *
+                 * @tparam MODULE モジュールのクラス
+                 *
+                 * Quectel BG770Aモジュールのファイルシステム(UFS)を操作するコマンドです。
+                 * 大きなファイルは、呼び出し元のバッファを使って分割して転送できます。
+                 */
+                template <typename MODULE>
+                class Bg770aFileCommands
+                {
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief ファイル情報
+                     */
+                    struct FileInfo
+                    {
+                        /**
+                         * @~Japanese
+                         * @brief ファイル名
+                         */
+                        std::string name;
+                        /**
+                         * @~Japanese
+                         * @brief ファイルサイズ[バイト]
+                         */
+                        size_t size;
+                    };
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルの一覧を取得
+                     *
+                     * @param [in] pattern ファイル名のパターン。"*"を指定すると全てのファイル。
+                     * @param [out] files ファイル情報。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * ファイルの一覧を取得します。
+                     * 該当するファイルが無いときもエラーにせず、空の一覧を返します。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.2. AT+QFLST List Files
+                     */
+                    WioCellularResult listFiles(const std::string &pattern, std::vector<FileInfo> *files)
+                    {
+                        assert(!pattern.empty());
+
+                        if (files)
+                            files->clear();
+
+                        size_t count = 0;
+                        const auto result = static_cast<MODULE &>(*this).queryCommand(
+                            internal::stringFormat("AT+QFLST=\"%s\"", pattern.c_str()), [files, &count](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QFLST: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() != 2) return false;
+                                    std::string name = parser[0];
+                                    internal::stringStartsWith(name, "UFS:", &name);
+                                    if (files) files->push_back({name, static_cast<size_t>(std::stoul(parser[1]))});
+                                    ++count;
+                                    return true;
+                                }
+                                return false; },
+                            300);
+
+                        // +CME ERROR: 405 (File not found) is returned when nothing matches
+                        return result == WioCellularResult::CommandRejected && count == 0 ? WioCellularResult::Ok : result;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルを削除
+                     *
+                     * @param [in] name ファイル名。"*"を指定すると全てのファイル。
+                     * @return 実行結果。
+                     *
+                     * ファイルを削除します。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.3. AT+QFDEL Delete Files
+                     */
+                    WioCellularResult deleteFile(const std::string &name)
+                    {
+                        assert(!name.empty());
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QFDEL=\"%s\"", name.c_str()), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルをアップロード
+                     *
+                     * @param [in] name ファイル名。
+                     * @param [in] data データ。
+                     * @param [in] dataSize データサイズ。
+                     * @return 実行結果。
+                     *
+                     * データをモジュールのファイルへアップロードします。
+                     * CONNECTを受信した後に、データをまとめて書き込みます。
+                     * 同じ名前のファイルがあるときはエラーになります。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.4. AT+QFUPL Upload a File to UFS
+                     */
+                    WioCellularResult uploadFile(const std::string &name, const void *data, size_t dataSize)
+                    {
+                        assert(!name.empty());
+                        assert(data);
+                        assert(dataSize >= 1);
+
+                        WioCellularResult result;
+
+                        size_t uploadSize = 0;
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(
+                                 internal::stringFormat("AT+QFUPL=\"%s\",%d,60", name.c_str(), dataSize), [this, data, dataSize, &uploadSize](const std::string &response) -> bool
+                                 {
+                                    if (response == "CONNECT")
+                                    {
+                                        static_cast<MODULE &>(*this).writeBinary(data, dataSize);
+                                        return true;
+                                    }
+                                    std::string responseParameter;
+                                    if (internal::stringStartsWith(response, "+QFUPL: ", &responseParameter))
+                                    {
+                                        at_client::AtParameterParser parser{responseParameter};
+                                        if (parser.size() < 1) return false;
+                                        uploadSize = std::stoul(parser[0]);
+                                        return true;
+                                    }
+                                    return false; },
+                                 120000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (uploadSize != dataSize)
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルを分割してアップロード
+                     *
+                     * @param [in] name ファイル名。
+                     * @param [in] fileSize ファイルサイズ。
+                     * @param [in,out] buffer 書き込みに使うバッファ。
+                     * @param [in] bufferSize バッファのサイズ。
+                     * @param [in] source バッファへデータを書き込む関数。書き込んだサイズを返します。
+                     * @return 実行結果。
+                     *
+                     * sourceが返すデータを、CONNECTを受信した後にbufferSizeずつ書き込みます。
+                     * ファイル全体をメモリに保持しないので、bufferSizeより大きなファイルをアップロードできます。
+                     * モジュールは60秒間データが届かないとアップロードを中止するので、sourceは1回あたり60秒以内に返してください。
+                     * sourceがfileSizeに達する前に0を返したときは、モジュールがタイムアウトするのを待ってエラーを返します。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.4. AT+QFUPL Upload a File to UFS
+                     */
+                    WioCellularResult uploadFile(const std::string &name, size_t fileSize, void *buffer, size_t bufferSize, const std::function<size_t(void *data, size_t dataSize)> &source)
+                    {
+                        assert(!name.empty());
+                        assert(fileSize >= 1);
+                        assert(buffer);
+                        assert(bufferSize >= 1);
+                        assert(source);
+
+                        WioCellularResult result;
+
+                        size_t uploadSize = 0;
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(
+                                 internal::stringFormat("AT+QFUPL=\"%s\",%d,60", name.c_str(), fileSize), [this, fileSize, buffer, bufferSize, &source, &uploadSize](const std::string &response) -> bool
+                                 {
+                                    if (response == "CONNECT")
+                                    {
+                                        size_t remain = fileSize;
+                                        while (remain >= 1)
+                                        {
+                                            const auto size = source(buffer, std::min(remain, bufferSize));
+                                            if (size == 0) break;
+                                            static_cast<MODULE &>(*this).writeBinary(buffer, size);
+                                            remain -= size;
+                                        }
+                                        return true;
+                                    }
+                                    std::string responseParameter;
+                                    if (internal::stringStartsWith(response, "+QFUPL: ", &responseParameter))
+                                    {
+                                        at_client::AtParameterParser parser{responseParameter};
+                                        if (parser.size() < 1) return false;
+                                        uploadSize = std::stoul(parser[0]);
+                                        return true;
+                                    }
+                                    return false; },
+                                 120000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (uploadSize != fileSize)
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルをダウンロード
+                     *
+                     * @param [in] name ファイル名。
+                     * @param [in,out] buffer 読み込みに使うバッファ。
+                     * @param [in] bufferSize バッファのサイズ。
+                     * @param [in] sink 読み込んだデータを受け取る関数。falseを返すと残りのデータを破棄します。
+                     * @return 実行結果。
+                     *
+                     * ファイルの内容を、bufferSizeずつsinkへ渡します。
+                     * CONNECTの後のデータの終わりを判別するために、AT+QFLSTでファイルサイズを取得してからダウンロードします。
+                     * ダウンロード中は読み込みを止められないので、sinkの処理を待てないときはstreamFile()を使ってください。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.5. AT+QFDWL Download a File from UFS
+                     */
+                    WioCellularResult downloadFile(const std::string &name, void *buffer, size_t bufferSize, const std::function<bool(const void *data, size_t dataSize)> &sink)
+                    {
+                        assert(!name.empty());
+                        assert(buffer);
+                        assert(bufferSize >= 1);
+                        assert(sink);
+
+                        WioCellularResult result;
+
+                        std::vector<FileInfo> files;
+                        if ((result = listFiles(name, &files)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (files.size() != 1)
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+                        const auto fileSize = files[0].size;
+
+                        bool completed = false;
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(
+                                 internal::stringFormat("AT+QFDWL=\"%s\"", name.c_str()), [this, fileSize, buffer, bufferSize, &sink, &completed](const std::string &response) -> bool
+                                 {
+                                    if (response == "CONNECT")
+                                    {
+                                        bool accepting = true;
+                                        size_t remain = fileSize;
+                                        while (remain >= 1)
+                                        {
+                                            const auto size = std::min(remain, bufferSize);
+                                            if (accepting)
+                                            {
+                                                if (!static_cast<MODULE &>(*this).readBinary(buffer, size, 10000)) return true;
+                                                accepting = sink(buffer, size);
+                                            }
+                                            else
+                                            {
+                                                if (!static_cast<MODULE &>(*this).readBinaryDiscard(size, 10000)) return true;
+                                            }
+                                            remain -= size;
+                                        }
+                                        completed = true;
+                                        return true;
+                                    }
+                                    if (internal::stringStartsWith(response, "+QFDWL: ")) return true;
+                                    return false; },
+                                 120000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (!completed)
+                        {
+                            return WioCellularResult::ReceiveTimeout;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルをオープン
+                     *
+                     * @param [in] name ファイル名。
+                     * @param [in] mode モード。
+                     *   @arg 0: 無ければ作成して、読み書き
+                     *   @arg 1: 作成もしくは空にして、読み書き
+                     *   @arg 2: 読み込みのみ
+                     * @param [out] fileHandle ファイルハンドル。
+                     * @return 実行結果。
+                     *
+                     * ファイルをオープンします。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.6. AT+QFOPEN Open a File
+                     */
+                    WioCellularResult openFile(const std::string &name, int mode, int *fileHandle)
+                    {
+                        assert(!name.empty());
+                        assert(0 <= mode && mode <= 2);
+                        assert(fileHandle);
+
+                        *fileHandle = -1;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            internal::stringFormat("AT+QFOPEN=\"%s\",%d", name.c_str(), mode), [fileHandle](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QFOPEN: ", &responseParameter))
+                                {
+                                    *fileHandle = std::stoi(responseParameter);
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルから読み込み
+                     *
+                     * @param [in] fileHandle ファイルハンドル。
+                     * @param [out] data データ。
+                     * @param [in] dataSize 読み込む最大サイズ。
+                     * @param [out] readDataSize 読み込んだサイズ。ファイルの終わりでは0。
+                     * @return 実行結果。
+                     *
+                     * ファイルの現在位置から読み込みます。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.7. AT+QFREAD Read a File
+                     */
+                    WioCellularResult readFile(int fileHandle, void *data, size_t dataSize, size_t *readDataSize)
+                    {
+                        assert(data);
+                        assert(dataSize >= 1);
+                        assert(readDataSize);
+
+                        *readDataSize = 0;
+
+                        bool completed = true;
+                        WioCellularResult result;
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(
+                                 internal::stringFormat("AT+QFREAD=%d,%d", fileHandle, dataSize), [this, data, dataSize, readDataSize, &completed](const std::string &response) -> bool
+                                 {
+                                    std::string responseParameter;
+                                    if (internal::stringStartsWith(response, "CONNECT ", &responseParameter))
+                                    {
+                                        const size_t size = std::stoul(responseParameter);
+                                        assert(size <= dataSize);
+                                        if (size == 0) return true;
+                                        completed = static_cast<MODULE &>(*this).readBinary(data, size, 10000);
+                                        if (completed) *readDataSize = size;
+                                        return true;
+                                    }
+                                    return false; },
+                                 10000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (!completed)
+                        {
+                            return WioCellularResult::ReceiveTimeout;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルへ書き込み
+                     *
+                     * @param [in] fileHandle ファイルハンドル。
+                     * @param [in] data データ。
+                     * @param [in] dataSize データサイズ。
+                     * @return 実行結果。
+                     *
+                     * ファイルの現在位置へ書き込みます。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.8. AT+QFWRITE Write a File
+                     */
+                    WioCellularResult writeFile(int fileHandle, const void *data, size_t dataSize)
+                    {
+                        assert(data);
+                        assert(dataSize >= 1);
+
+                        WioCellularResult result;
+
+                        size_t writtenSize = 0;
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(
+                                 internal::stringFormat("AT+QFWRITE=%d,%d,5", fileHandle, dataSize), [this, data, dataSize, &writtenSize](const std::string &response) -> bool
+                                 {
+                                    if (response == "CONNECT")
+                                    {
+                                        static_cast<MODULE &>(*this).writeBinary(data, dataSize);
+                                        return true;
+                                    }
+                                    std::string responseParameter;
+                                    if (internal::stringStartsWith(response, "+QFWRITE: ", &responseParameter))
+                                    {
+                                        at_client::AtParameterParser parser{responseParameter};
+                                        if (parser.size() < 1) return false;
+                                        writtenSize = std::stoul(parser[0]);
+                                        return true;
+                                    }
+                                    return false; },
+                                 10000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (writtenSize != dataSize)
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルの位置を設定
+                     *
+                     * @param [in] fileHandle ファイルハンドル。
+                     * @param [in] offset ファイルの先頭からの位置[バイト]。
+                     * @return 実行結果。
+                     *
+                     * ファイルの現在位置を設定します。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.9. AT+QFSEEK Set File Pointer to Specified Position
+                     */
+                    WioCellularResult seekFile(int fileHandle, size_t offset)
+                    {
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QFSEEK=%d,%d,0", fileHandle, offset), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルをクローズ
+                     *
+                     * @param [in] fileHandle ファイルハンドル。
+                     * @return 実行結果。
+                     *
+                     * ファイルをクローズします。
+                     *
+                     * > BG95&BG77&BG600L Series FILE Application Note @n
+                     * > 2.2.12. AT+QFCLOSE Close a File
+                     */
+                    WioCellularResult closeFile(int fileHandle)
+                    {
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QFCLOSE=%d", fileHandle), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ファイルを読み込んで渡す
+                     *
+                     * @param [in] name ファイル名。
+                     * @param [in] offset 読み込みを開始する位置[バイト]。
+                     * @param [in,out] buffer 読み込みに使うバッファ。
+                     * @param [in] bufferSize バッファのサイズ。
+                     * @param [in] sink 読み込んだデータを受け取る関数。falseを返すと読み込みを中断します。
+                     * @param [out] streamedSize sinkへ渡したサイズ。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * AT+QFREADでbufferSizeずつ読み込んで、sinkへ渡します。
+                     * sinkから戻るまで次の読み込みをしないので、sinkの処理が遅くてもデータを取りこぼしません。
+                     * 中断したときは、offsetに*streamedSizeを加えて呼び出すと続きから読み込めます。
+                     */
+                    WioCellularResult streamFile(const std::string &name, size_t offset, void *buffer, size_t bufferSize, const std::function<bool(const void *data, size_t dataSize)> &sink, size_t *streamedSize)
+                    {
+                        assert(!name.empty());
+                        assert(buffer);
+                        assert(bufferSize >= 1);
+                        assert(sink);
+
+                        if (streamedSize)
+                            *streamedSize = 0;
+
+                        WioCellularResult result;
+
+                        int fileHandle;
+                        if ((result = openFile(name, 2, &fileHandle)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (offset >= 1)
+                        {
+                            if ((result = seekFile(fileHandle, offset)) != WioCellularResult::Ok)
+                            {
+                                closeFile(fileHandle);
+                                return result;
+                            }
+                        }
+
+                        while (true)
+                        {
+                            size_t size;
+                            if ((result = readFile(fileHandle, buffer, bufferSize, &size)) != WioCellularResult::Ok)
+                                break;
+                            if (size == 0)
+                                break;
+                            if (streamedSize)
+                                *streamedSize += size;
+                            if (!sink(buffer, size))
+                                break;
+                        }
+
+                        closeFile(fileHandle);
+
+                        return result;
+                    }
+                };
+
+            }
+        }
+    }
+}
+
+#endif // BG770AFILECOMMANDS_HPP
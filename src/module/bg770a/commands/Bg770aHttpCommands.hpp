@@ -0,0 +1,298 @@
+/*
+ * Bg770aHttpCommands.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef BG770AHTTPCOMMANDS_HPP
+#define BG770AHTTPCOMMANDS_HPP
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "module/at_client/AtParameterParser.hpp"
+#include "internal/Misc.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace module
+    {
+        namespace bg770a
+        {
+            namespace commands
+            {
+
+                /**
+                 * @~Japanese
+                 * @brief Quectel BG770AモジュールのHTTP(S)コマンド
+                 *
+                 * @tparam MODULE モジュールのクラス
+                 *
+                 * Quectel BG770AモジュールのHTTP(S)コマンドです。
+                 * HTTPの処理をモジュールで行います。
+                 */
+                template <typename MODULE>
+                class Bg770aHttpCommands
+                {
+                private:
+                    WioCellularResult queryCommandAndWaitResult(const std::string &command, const std::function<bool(const std::string &response)> &informationTextHandler, int commandTimeout, const std::string &prefix, std::vector<std::string> *parameters, int timeout)
+                    {
+                        WioCellularResult result = WioCellularResult::Ok;
+
+                        bool received = false;
+                        const auto handler = static_cast<MODULE &>(*this).registerUrcHandler([&prefix, &received, parameters](const std::string &response) -> bool
+                                                                                             {
+                                                                                                std::string responseParameter;
+                                                                                                if (internal::stringStartsWith(response, prefix, &responseParameter))
+                                                                                                {
+                                                                                                    at_client::AtParameterParser parser{responseParameter};
+                                                                                                    parameters->clear();
+                                                                                                    for (size_t i = 0; i < parser.size(); ++i) parameters->push_back(parser[i]);
+                                                                                                    received = true;
+                                                                                                    return true;
+                                                                                                }
+                                                                                                return false; });
+
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(command, informationTextHandler, commandTimeout)) == WioCellularResult::Ok)
+                        {
+                            const auto start = millis();
+                            while (!received)
+                            {
+                                static_cast<MODULE &>(*this).doWork(timeout - (millis() - start));
+                                if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                                {
+                                    result = WioCellularResult::ReadResponseTimeout;
+                                    break;
+                                }
+                            }
+                        }
+                        static_cast<MODULE &>(*this).unregisterUrcHandler(handler);
+                        if (result != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        // <err> 0: Operation successful
+                        if (parameters->empty() || (*parameters)[0] != "0")
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    static void parseHttpResponse(const std::vector<std::string> &parameters, int *httpStatus, size_t *contentLength)
+                    {
+                        if (httpStatus && parameters.size() >= 2)
+                            *httpStatus = std::stoi(parameters[1]);
+                        if (contentLength && parameters.size() >= 3)
+                            *contentLength = std::stoul(parameters[2]);
+                    }
+
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief HTTPのオプションを設定
+                     *
+                     * @param [in] name オプション名。例: "contextid", "sslctxid", "contenttype", "responseheader"
+                     * @param [in] option パラメータ。例: "1"
+                     * @return 実行結果。
+                     *
+                     * AT+QHTTPCFGで、HTTPのオプションを設定します。
+                     *
+                     * > BG95&BG77&BG600L Series HTTP(S) Application Note @n
+                     * > 2.2.1. AT+QHTTPCFG Configure Parameters for HTTP(S) Server
+                     */
+                    WioCellularResult setHttpOption(const std::string &name, const std::string &option)
+                    {
+                        assert(!name.empty());
+                        assert(!option.empty());
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QHTTPCFG=\"%s\",%s", name.c_str(), option.c_str()), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief HTTPのURLを設定
+                     *
+                     * @param [in] url URL。例: "https://example.com/path"
+                     * @return 実行結果。
+                     *
+                     * HTTPのURLを設定します。
+                     *
+                     * > BG95&BG77&BG600L Series HTTP(S) Application Note @n
+                     * > 2.2.2. AT+QHTTPURL Set URL of HTTP(S) Server
+                     */
+                    WioCellularResult setHttpUrl(const std::string &url)
+                    {
+                        assert(1 <= url.size() && url.size() <= 700);
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            internal::stringFormat("AT+QHTTPURL=%d,80", url.size()), [this, &url](const std::string &response) -> bool
+                            {
+                                if (response == "CONNECT")
+                                {
+                                    static_cast<MODULE &>(*this).writeBinary(url.data(), url.size());
+                                    return true;
+                                }
+                                return false; },
+                            90000);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief HTTPのGETリクエストを送信
+                     *
+                     * @param [in] responseTime レスポンスを待つ時間[秒]。
+                     * @param [out] httpStatus HTTPステータスコード。nullptrを指定すると値を代入しません。
+                     * @param [out] contentLength レスポンスボディのサイズ。Content-Lengthが無いときは0。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * setHttpUrl()で設定したURLへGETリクエストを送信して、レスポンスヘッダーを受信するまで待ちます。
+                     *
+                     * > BG95&BG77&BG600L Series HTTP(S) Application Note @n
+                     * > 2.2.3. AT+QHTTPGET Send GET Request to HTTP(S) Server
+                     */
+                    WioCellularResult getHttp(int responseTime, int *httpStatus, size_t *contentLength)
+                    {
+                        assert(1 <= responseTime && responseTime <= 65535);
+
+                        if (httpStatus)
+                            *httpStatus = -1;
+                        if (contentLength)
+                            *contentLength = 0;
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = queryCommandAndWaitResult(internal::stringFormat("AT+QHTTPGET=%d", responseTime), nullptr, 300, "+QHTTPGET: ", &parameters, responseTime * 1000 + 10000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        parseHttpResponse(parameters, httpStatus, contentLength);
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief HTTPのPOSTリクエストを送信
+                     *
+                     * @param [in] data リクエストボディ。
+                     * @param [in] dataSize リクエストボディのサイズ。
+                     * @param [in] responseTime レスポンスを待つ時間[秒]。
+                     * @param [out] httpStatus HTTPステータスコード。nullptrを指定すると値を代入しません。
+                     * @param [out] contentLength レスポンスボディのサイズ。Content-Lengthが無いときは0。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * setHttpUrl()で設定したURLへPOSTリクエストを送信して、レスポンスヘッダーを受信するまで待ちます。
+                     * CONNECTを受信した後に、リクエストボディをまとめて書き込みます。
+                     *
+                     * > BG95&BG77&BG600L Series HTTP(S) Application Note @n
+                     * > 2.2.4. AT+QHTTPPOST Send POST Request to HTTP(S) Server via UART/USB
+                     */
+                    WioCellularResult postHttp(const void *data, size_t dataSize, int responseTime, int *httpStatus, size_t *contentLength)
+                    {
+                        assert(data);
+                        assert(1 <= dataSize);
+                        assert(1 <= responseTime && responseTime <= 65535);
+
+                        if (httpStatus)
+                            *httpStatus = -1;
+                        if (contentLength)
+                            *contentLength = 0;
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = queryCommandAndWaitResult(
+                                 internal::stringFormat("AT+QHTTPPOST=%d,80,%d", dataSize, responseTime), [this, data, dataSize](const std::string &response) -> bool
+                                 {
+                                    if (response == "CONNECT")
+                                    {
+                                        static_cast<MODULE &>(*this).writeBinary(data, dataSize);
+                                        return true;
+                                    }
+                                    return false; },
+                                 90000, "+QHTTPPOST: ", &parameters, responseTime * 1000 + 10000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        parseHttpResponse(parameters, httpStatus, contentLength);
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief HTTPのレスポンスボディを読み込み
+                     *
+                     * @param [in] contentLength レスポンスボディのサイズ。getHttp()かpostHttp()で得たサイズ。
+                     * @param [in,out] buffer 読み込みに使うバッファ。
+                     * @param [in] bufferSize バッファのサイズ。
+                     * @param [in] sink 読み込んだデータを受け取る関数。falseを返すと残りのデータを破棄します。
+                     * @param [in] waitTime データを待つ時間[秒]。
+                     * @return 実行結果。
+                     *
+                     * HTTPのレスポンスボディを、bufferSizeずつsinkへ渡します。
+                     * ボディ全体をメモリに保持しないので、bufferSizeより大きなボディを読み込めます。
+                     * CONNECTの後のボディの終わりを判別するためにサイズが必要なので、Content-Lengthが無いレスポンスは読み込めません。
+                     *
+                     * > BG95&BG77&BG600L Series HTTP(S) Application Note @n
+                     * > 2.2.6. AT+QHTTPREAD Read Response from HTTP(S) Server via UART/USB
+                     */
+                    WioCellularResult readHttp(size_t contentLength, void *buffer, size_t bufferSize, const std::function<bool(const void *data, size_t dataSize)> &sink, int waitTime)
+                    {
+                        assert(1 <= contentLength);
+                        assert(buffer);
+                        assert(1 <= bufferSize);
+                        assert(sink);
+                        assert(1 <= waitTime && waitTime <= 65535);
+
+                        bool completed = false;
+                        std::vector<std::string> parameters;
+                        const auto result = queryCommandAndWaitResult(
+                            internal::stringFormat("AT+QHTTPREAD=%d", waitTime), [this, contentLength, buffer, bufferSize, &sink, &completed](const std::string &response) -> bool
+                            {
+                                if (response == "CONNECT")
+                                {
+                                    bool accepting = true;
+                                    size_t remain = contentLength;
+                                    while (remain >= 1)
+                                    {
+                                        const auto size = std::min(remain, bufferSize);
+                                        if (accepting)
+                                        {
+                                            if (!static_cast<MODULE &>(*this).readBinary(buffer, size, 10000)) return true;
+                                            accepting = sink(buffer, size);
+                                        }
+                                        else
+                                        {
+                                            if (!static_cast<MODULE &>(*this).readBinaryDiscard(size, 10000)) return true;
+                                        }
+                                        remain -= size;
+                                    }
+                                    completed = true;
+                                    return true;
+                                }
+                                return false; },
+                            waitTime * 1000 + 10000, "+QHTTPREAD: ", &parameters, 10000);
+                        if (result != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (!completed)
+                        {
+                            return WioCellularResult::ReceiveTimeout;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+                };
+
+            }
+        }
+    }
+}
+
+#endif // BG770AHTTPCOMMANDS_HPP
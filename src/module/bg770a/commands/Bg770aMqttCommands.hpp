@@ -0,0 +1,379 @@
+/*
+ * Bg770aMqttCommands.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef BG770AMQTTCOMMANDS_HPP
+#define BG770AMQTTCOMMANDS_HPP
+
+#include <vector>
+#include "module/at_client/AtParameterParser.hpp"
+#include "internal/Misc.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace module
+    {
+        namespace bg770a
+        {
+            namespace commands
+            {
+
+                /**
+                 * @~Japanese
+                 * @brief Quectel BG770AモジュールのMQTTコマンド
+                 *
+                 * @tparam MODULE モジュールのクラス
+                 *
+                 * Quectel BG770AモジュールのMQTTコマンドです。
+                 * MQTTのプロトコル処理をモジュールで行います。
+                 * 受信したメッセージ(+QMTRECV)や切断(+QMTSTAT)のURCは、registerUrcHandler()で登録したハンドラで処理してください。
+                 */
+                template <typename MODULE>
+                class Bg770aMqttCommands
+                {
+                private:
+                    static constexpr int COMMAND_ECHO_TIMEOUT = 10000;
+
+                    /**
+                     * @~Japanese
+                     * @brief コマンドを実行して結果のURCを待つ
+                     *
+                     * @param [in] command コマンド。
+                     * @param [in] prefix 結果のURCの接頭辞。例: "+QMTOPEN: 0,"
+                     * @param [out] parameters 接頭辞に続くパラメータ。
+                     * @param [in] timeout 結果のURCを待つタイムアウト時間[ミリ秒]。
+                     * @return 実行結果。
+                     */
+                    WioCellularResult executeCommandAndWaitResult(const std::string &command, const std::string &prefix, std::vector<std::string> *parameters, int timeout)
+                    {
+                        WioCellularResult result = WioCellularResult::Ok;
+
+                        bool received = false;
+                        const auto handler = static_cast<MODULE &>(*this).registerUrcHandler([&prefix, &received, parameters](const std::string &response) -> bool
+                                                                                             {
+                                                                                                std::string responseParameter;
+                                                                                                if (internal::stringStartsWith(response, prefix, &responseParameter))
+                                                                                                {
+                                                                                                    at_client::AtParameterParser parser{responseParameter};
+                                                                                                    parameters->clear();
+                                                                                                    for (size_t i = 0; i < parser.size(); ++i) parameters->push_back(parser[i]);
+                                                                                                    received = true;
+                                                                                                    return true;
+                                                                                                }
+                                                                                                return false; });
+
+                        if ((result = static_cast<MODULE &>(*this).executeCommand(command, 300)) == WioCellularResult::Ok)
+                        {
+                            const auto start = millis();
+                            while (!received)
+                            {
+                                static_cast<MODULE &>(*this).doWork(timeout - (millis() - start));
+                                if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                                {
+                                    result = WioCellularResult::ReadResponseTimeout;
+                                    break;
+                                }
+                            }
+                        }
+                        static_cast<MODULE &>(*this).unregisterUrcHandler(handler);
+                        if (result != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (parameters->empty())
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief MQTTのオプションを設定
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @param [in] name オプション名。例: "pdpcid", "version", "keepalive", "recv/mode"
+                     * @param [in] option クライアントのインデックスに続くパラメータ。例: "60"
+                     * @return 実行結果。
+                     *
+                     * AT+QMTCFGで、MQTTクライアントのオプションを設定します。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.1. AT+QMTCFG Configure Optional Parameters of MQTT
+                     */
+                    WioCellularResult setMqttOption(int clientIndex, const std::string &name, const std::string &option)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+                        assert(!name.empty());
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QMTCFG=\"%s\",%d%s%s", name.c_str(), clientIndex, option.empty() ? "" : ",", option.c_str()), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief MQTTのネットワークをオープン
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @param [in] hostName ホスト名もしくはIPアドレス。
+                     * @param [in] port ポート番号。
+                     * @return 実行結果。
+                     *
+                     * MQTTサーバーとのTCP接続をオープンします。
+                     * +QMTOPENのURCを受信するまで待ちます。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.2. AT+QMTOPEN Open a Network Connection for MQTT Client
+                     */
+                    WioCellularResult openMqtt(int clientIndex, const std::string &hostName, int port)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+                        assert(!hostName.empty());
+                        assert(0 <= port && port <= 65535);
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = executeCommandAndWaitResult(internal::stringFormat("AT+QMTOPEN=%d,\"%s\",%d", clientIndex, hostName.c_str(), port), internal::stringFormat("+QMTOPEN: %d,", clientIndex), &parameters, 120000)) != WioCellularResult::Ok)
+                        {
+                            return result == WioCellularResult::ReadResponseTimeout ? WioCellularResult::OpenTimeout : result;
+                        }
+                        if (parameters[0] != "0")
+                        {
+                            return WioCellularResult::OpenError;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief MQTTのネットワークをクローズ
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @return 実行結果。
+                     *
+                     * MQTTサーバーとのTCP接続をクローズします。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.3. AT+QMTCLOSE Close a Network Connection for MQTT Client
+                     */
+                    WioCellularResult closeMqtt(int clientIndex)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = executeCommandAndWaitResult(internal::stringFormat("AT+QMTCLOSE=%d", clientIndex), internal::stringFormat("+QMTCLOSE: %d,", clientIndex), &parameters, 30000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (parameters[0] != "0")
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief MQTTサーバーに接続
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @param [in] clientId クライアントID。
+                     * @param [in] userName ユーザー名。空文字列を指定すると省略します。
+                     * @param [in] password パスワード。空文字列を指定すると省略します。
+                     * @return 実行結果。
+                     *
+                     * MQTTサーバーに接続(CONNECT)します。
+                     * +QMTCONNのURCを受信するまで待ちます。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.4. AT+QMTCONN Connect a Client to MQTT Server
+                     */
+                    WioCellularResult connectMqtt(int clientIndex, const std::string &clientId, const std::string &userName, const std::string &password)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+                        assert(!clientId.empty());
+
+                        WioCellularResult result;
+
+                        std::string command = internal::stringFormat("AT+QMTCONN=%d,\"%s\"", clientIndex, clientId.c_str());
+                        if (!userName.empty())
+                        {
+                            command += internal::stringFormat(",\"%s\"", userName.c_str());
+                            if (!password.empty())
+                                command += internal::stringFormat(",\"%s\"", password.c_str());
+                        }
+
+                        std::vector<std::string> parameters;
+                        if ((result = executeCommandAndWaitResult(command, internal::stringFormat("+QMTCONN: %d,", clientIndex), &parameters, 30000)) != WioCellularResult::Ok)
+                        {
+                            return result == WioCellularResult::ReadResponseTimeout ? WioCellularResult::OpenTimeout : result;
+                        }
+                        if (parameters[0] != "0" || (parameters.size() >= 2 && parameters[1] != "0"))
+                        {
+                            return WioCellularResult::OpenError;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief MQTTサーバーから切断
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @return 実行結果。
+                     *
+                     * MQTTサーバーから切断(DISCONNECT)します。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.5. AT+QMTDISC Disconnect a Client from MQTT Server
+                     */
+                    WioCellularResult disconnectMqtt(int clientIndex)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = executeCommandAndWaitResult(internal::stringFormat("AT+QMTDISC=%d", clientIndex), internal::stringFormat("+QMTDISC: %d,", clientIndex), &parameters, 30000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (parameters[0] != "0")
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief トピックを購読
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @param [in] messageId メッセージID。1～65535
+                     * @param [in] topic トピック。
+                     * @param [in] qos QoS。0～2
+                     * @return 実行結果。
+                     *
+                     * トピックを購読(SUBSCRIBE)します。
+                     * +QMTSUBのURCを受信するまで待ちます。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.6. AT+QMTSUB Subscribe to Topics
+                     */
+                    WioCellularResult subscribeMqtt(int clientIndex, int messageId, const std::string &topic, int qos)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+                        assert(1 <= messageId && messageId <= 65535);
+                        assert(!topic.empty());
+                        assert(0 <= qos && qos <= 2);
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = executeCommandAndWaitResult(internal::stringFormat("AT+QMTSUB=%d,%d,\"%s\",%d", clientIndex, messageId, topic.c_str(), qos), internal::stringFormat("+QMTSUB: %d,%d,", clientIndex, messageId), &parameters, 30000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (parameters[0] != "0" || (parameters.size() >= 2 && parameters[1] == "128"))
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief トピックの購読を解除
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @param [in] messageId メッセージID。1～65535
+                     * @param [in] topic トピック。
+                     * @return 実行結果。
+                     *
+                     * トピックの購読を解除(UNSUBSCRIBE)します。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.7. AT+QMTUNS Unsubscribe from Topics
+                     */
+                    WioCellularResult unsubscribeMqtt(int clientIndex, int messageId, const std::string &topic)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+                        assert(1 <= messageId && messageId <= 65535);
+                        assert(!topic.empty());
+
+                        WioCellularResult result;
+
+                        std::vector<std::string> parameters;
+                        if ((result = executeCommandAndWaitResult(internal::stringFormat("AT+QMTUNS=%d,%d,\"%s\"", clientIndex, messageId, topic.c_str()), internal::stringFormat("+QMTUNS: %d,%d,", clientIndex, messageId), &parameters, 30000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (parameters[0] != "0")
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief メッセージを発行
+                     *
+                     * @param [in] clientIndex クライアントのインデックス。0～5
+                     * @param [in] messageId メッセージID。QoS0のときは0、それ以外は1～65535
+                     * @param [in] qos QoS。0～2
+                     * @param [in] retain リテイン。
+                     * @param [in] topic トピック。
+                     * @param [in] data データ。
+                     * @param [in] dataSize データサイズ。
+                     * @return 実行結果。
+                     *
+                     * メッセージを発行(PUBLISH)します。
+                     * モジュールがデータを受け付けた時点(OK)で戻り、発行結果のURC(+QMTPUB: <clientIndex>,<messageId>,<result>)は待ちません。
+                     * 発行結果はregisterUrcHandler()で登録したハンドラで受け取ってください。
+                     *
+                     * > BG95&BG77&BG600L Series MQTT Application Note @n
+                     * > 3.3.8. AT+QMTPUB Publish Messages
+                     */
+                    WioCellularResult publishMqtt(int clientIndex, int messageId, int qos, bool retain, const std::string &topic, const void *data, size_t dataSize)
+                    {
+                        assert(0 <= clientIndex && clientIndex <= 5);
+                        assert(qos == 0 ? messageId == 0 : 1 <= messageId && messageId <= 65535);
+                        assert(0 <= qos && qos <= 2);
+                        assert(!topic.empty());
+                        assert(data);
+                        assert(1 <= dataSize && dataSize <= 4096);
+
+                        return static_cast<MODULE &>(*this).promptCommand(internal::stringFormat("AT+QMTPUB=%d,%d,%d,%d,\"%s\",%d", clientIndex, messageId, qos, retain ? 1 : 0, topic.c_str(), dataSize), [this, data, dataSize](const std::string &response) -> bool
+                                                                          {
+                                                                            if (response == "> ")
+                                                                            {
+                                                                                static_cast<MODULE &>(*this).writeBinary(data, dataSize);
+                                                                                static_cast<MODULE &>(*this).readBinaryDiscard(dataSize, COMMAND_ECHO_TIMEOUT);
+                                                                                return true;
+                                                                            }
+                                                                            return false; },
+                                                                          10000);
+                    }
+                };
+
+            }
+        }
+    }
+}
+
+#endif // BG770AMQTTCOMMANDS_HPP
@@ -7,6 +7,7 @@
 #ifndef BG770ANETWORKSERVICECOMMANDS_HPP
 #define BG770ANETWORKSERVICECOMMANDS_HPP
 
+#include <vector>
 #include "module/at_client/AtParameterParser.hpp"
 #include "internal/Misc.hpp"
 #include "WioCellularResult.hpp"
@@ -31,6 +32,190 @@ namespace wiocellular
                 template <typename MODULE>
                 class Bg770aNetworkServiceCommands
                 {
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief サービングセルの情報
+                     *
+                     * 値が無い項目は、文字列は空、数値は0です。
+                     */
+                    struct ServingCell
+                    {
+                        /**
+                         * @~Japanese
+                         * @brief 状態
+                         * * "SEARCH": 検索中
+                         * * "LIMSRV": 制限サービス
+                         * * "NOCONN": 待ち受け
+                         * * "CONNECT": 接続中
+                         */
+                        std::string state;
+                        /**
+                         * @~Japanese
+                         * @brief アクセステクノロジー
+                         * * "eMTC": LTE-M
+                         * * "NBIoT": NB-IoT
+                         */
+                        std::string act;
+                        /**
+                         * @~Japanese
+                         * @brief MCC(mobile country code)
+                         */
+                        std::string mcc;
+                        /**
+                         * @~Japanese
+                         * @brief MNC(mobile network code)
+                         */
+                        std::string mnc;
+                        /**
+                         * @~Japanese
+                         * @brief セルID
+                         */
+                        uint32_t cellId;
+                        /**
+                         * @~Japanese
+                         * @brief 物理セルID
+                         */
+                        int pcid;
+                        /**
+                         * @~Japanese
+                         * @brief チャネル番号(EARFCN)
+                         */
+                        int earfcn;
+                        /**
+                         * @~Japanese
+                         * @brief 周波数バンド
+                         */
+                        int band;
+                        /**
+                         * @~Japanese
+                         * @brief TAC(tracking area code)
+                         */
+                        uint32_t tac;
+                        /**
+                         * @~Japanese
+                         * @brief RSRP[dBm]
+                         */
+                        int rsrp;
+                        /**
+                         * @~Japanese
+                         * @brief RSRQ[dB]
+                         */
+                        int rsrq;
+                        /**
+                         * @~Japanese
+                         * @brief RSSI[dBm]
+                         */
+                        int rssi;
+                        /**
+                         * @~Japanese
+                         * @brief SINR[dB]
+                         */
+                        int sinr;
+                    };
+
+                    /**
+                     * @~Japanese
+                     * @brief 隣接セルの情報
+                     *
+                     * 値が無い項目は0です。
+                     */
+                    struct NeighbourCell
+                    {
+                        /**
+                         * @~Japanese
+                         * @brief 同じ周波数
+                         * * true: 同じ周波数(intra)
+                         * * false: 異なる周波数(inter)
+                         */
+                        bool intra;
+                        /**
+                         * @~Japanese
+                         * @brief チャネル番号(EARFCN)
+                         */
+                        int earfcn;
+                        /**
+                         * @~Japanese
+                         * @brief 物理セルID
+                         */
+                        int pcid;
+                        /**
+                         * @~Japanese
+                         * @brief RSRQ[dB]
+                         */
+                        int rsrq;
+                        /**
+                         * @~Japanese
+                         * @brief RSRP[dBm]
+                         */
+                        int rsrp;
+                        /**
+                         * @~Japanese
+                         * @brief RSSI[dBm]
+                         */
+                        int rssi;
+                        /**
+                         * @~Japanese
+                         * @brief SINR[dB]
+                         */
+                        int sinr;
+                    };
+
+                private:
+                    static int cellValueToInt(const std::string &value, int base = 10)
+                    {
+                        if (value.empty() || value == "-")
+                            return 0;
+
+                        return base == 10 ? std::stoi(value) : static_cast<int>(std::stoul(value, nullptr, base));
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief +QENG: "servingcell"のパラメーターを解析
+                     *
+                     * @param [in] parser "servingcell",以降のパラメーター。
+                     * @param [out] cell サービングセルの情報。nullptrを指定すると値を代入しません。
+                     * @retval true 成功
+                     * @retval false 未知のレイアウト
+                     *
+                     * eMTCとNB-IoTでは、<TAC>以降の位置が異なります。
+                     * eMTCは<UL_bandwidth>,<DL_bandwidth>の後に<TAC>が続き、NB-IoTは<freq_band_ind>の直後に<TAC>が続きます。
+                     */
+                    static bool parseServingCell(const at_client::AtParameterParser &parser, ServingCell *cell)
+                    {
+                        if (cell)
+                            cell->state = parser[0];
+                        if (parser.size() < 2) // "SEARCH", "LIMSRV"
+                            return true;
+
+                        size_t tacIndex;
+                        if (parser[1] == "eMTC")
+                            tacIndex = 11;
+                        else if (parser[1] == "NBIoT")
+                            tacIndex = 9;
+                        else
+                            return false;
+                        if (parser.size() < tacIndex + 5)
+                            return false;
+                        if (!cell)
+                            return true;
+
+                        cell->act = parser[1];
+                        cell->mcc = parser[3];
+                        cell->mnc = parser[4];
+                        cell->cellId = cellValueToInt(parser[5], 16);
+                        cell->pcid = cellValueToInt(parser[6]);
+                        cell->earfcn = cellValueToInt(parser[7]);
+                        cell->band = cellValueToInt(parser[8]);
+                        cell->tac = cellValueToInt(parser[tacIndex], 16);
+                        cell->rsrp = cellValueToInt(parser[tacIndex + 1]);
+                        cell->rsrq = cellValueToInt(parser[tacIndex + 2]);
+                        cell->rssi = cellValueToInt(parser[tacIndex + 3]);
+                        cell->sinr = cellValueToInt(parser[tacIndex + 4]);
+                        return true;
+                    }
+
                 public:
                     /**
                      * @~Japanese
@@ -142,6 +327,195 @@ namespace wiocellular
                             300);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief LTEの受信品質を取得
+                     *
+                     * @param [out] sysmode サービスモード。nullptrを指定すると値を代入しません。
+                     *   @arg "NOSERVICE": 圏外
+                     *   @arg "eMTC": LTE-M
+                     *   @arg "NBIoT": NB-IoT
+                     * @param [out] rssi RSSI[dBm]。nullptrを指定すると値を代入しません。
+                     * @param [out] rsrp RSRP[dBm]。nullptrを指定すると値を代入しません。
+                     * @param [out] sinr SINR。1/5dB単位で、0~250が-20~30[dB]。nullptrを指定すると値を代入しません。
+                     * @param [out] rsrq RSRQ[dB]。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * LTEの受信品質を取得します。
+                     * 圏外のときは、sysmode以外は0になります。
+                     *
+                     * 例: sysmode = "eMTC", rssi = -65, rsrp = -90, sinr = 150, rsrq = -11
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 6.11. AT+QCSQ Query and Report Signal Strength
+                     */
+                    WioCellularResult getExtendedSignalQuality(std::string *sysmode, int *rssi, int *rsrp, int *sinr, int *rsrq)
+                    {
+                        if (sysmode)
+                            sysmode->clear();
+                        if (rssi)
+                            *rssi = 0;
+                        if (rsrp)
+                            *rsrp = 0;
+                        if (sinr)
+                            *sinr = 0;
+                        if (rsrq)
+                            *rsrq = 0;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            "AT+QCSQ", [sysmode, rssi, rsrp, sinr, rsrq](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QCSQ: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() < 1) return false;
+                                    if (sysmode) *sysmode = parser[0];
+                                    if (parser.size() < 5) return true;
+                                    if (rssi) *rssi = std::stoi(parser[1]);
+                                    if (rsrp) *rsrp = std::stoi(parser[2]);
+                                    if (sinr) *sinr = std::stoi(parser[3]);
+                                    if (rsrq) *rsrq = std::stoi(parser[4]);
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ネットワーク情報を取得
+                     *
+                     * @param [out] act アクセステクノロジー。nullptrを指定すると値を代入しません。
+                     *   @arg "": 無し
+                     *   @arg "eMTC": LTE-M
+                     *   @arg "NBIoT": NB-IoT
+                     * @param [out] oper オペレーター(MCCとMNC)。nullptrを指定すると値を代入しません。
+                     * @param [out] band 周波数バンド。nullptrを指定すると値を代入しません。
+                     * @param [out] channel チャネル番号(EARFCN)。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * 登録しているネットワークの情報を取得します。
+                     * ネットワークに登録していないときは、actが空になります。
+                     *
+                     * 例: act = "eMTC", oper = "44010", band = "LTE BAND 19", channel = 6000
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 6.12. AT+QNWINFO Query Network Information
+                     */
+                    WioCellularResult getNetworkInformation(std::string *act, std::string *oper, std::string *band, int *channel)
+                    {
+                        if (act)
+                            act->clear();
+                        if (oper)
+                            oper->clear();
+                        if (band)
+                            band->clear();
+                        if (channel)
+                            *channel = -1;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            "AT+QNWINFO", [act, oper, band, channel](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QNWINFO: ", &responseParameter))
+                                {
+                                    if (responseParameter == "No Service") return true;
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() != 4) return false;
+                                    if (act) *act = parser[0];
+                                    if (oper) *oper = parser[1];
+                                    if (band) *band = parser[2];
+                                    if (channel) *channel = std::stoi(parser[3]);
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief サービングセルの情報を取得
+                     *
+                     * @param [out] cell サービングセルの情報。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * サービングセルの情報を取得します。
+                     * 検索中のときは、state以外は値がありません。
+                     * eMTCとNB-IoT以外のレイアウトのときは、WioCellularResult::CommandRejectedを返します。
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 6.13. AT+QENG Engineering Mode
+                     */
+                    WioCellularResult getServingCell(ServingCell *cell)
+                    {
+                        if (cell)
+                            *cell = {};
+
+                        WioCellularResult result;
+                        bool valid = false;
+                        if ((result = static_cast<MODULE &>(*this).queryCommand(
+                                 "AT+QENG=\"servingcell\"", [cell, &valid](const std::string &response) -> bool
+                                 {
+                                    std::string responseParameter;
+                                    if (internal::stringStartsWith(response, "+QENG: \"servingcell\",", &responseParameter))
+                                    {
+                                        at_client::AtParameterParser parser{responseParameter};
+                                        if (parser.size() < 1) return false;
+                                        valid = parseServingCell(parser, cell);
+                                        return true;
+                                    }
+                                    return false; },
+                                 300)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (!valid)
+                        {
+                            return WioCellularResult::CommandRejected;
+                        }
+
+                        return WioCellularResult::Ok;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief 隣接セルの情報を取得
+                     *
+                     * @param [out] cells 隣接セルの情報。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * 隣接セルの情報を取得します。
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 6.13. AT+QENG Engineering Mode
+                     */
+                    WioCellularResult getNeighbourCells(std::vector<NeighbourCell> *cells)
+                    {
+                        if (cells)
+                            cells->clear();
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            "AT+QENG=\"neighbourcell\"", [cells](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QENG: \"neighbourcell ", nullptr))
+                                {
+                                    at_client::AtParameterParser parser{response.substr(7)};
+                                    if (parser.size() < 8) return false;
+                                    if (cells) cells->push_back({parser[0] == "neighbourcell intra",
+                                                                 cellValueToInt(parser[2]),
+                                                                 cellValueToInt(parser[3]),
+                                                                 cellValueToInt(parser[4]),
+                                                                 cellValueToInt(parser[5]),
+                                                                 cellValueToInt(parser[6]),
+                                                                 cellValueToInt(parser[7])});
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief eDRXを設定
@@ -191,6 +565,49 @@ namespace wiocellular
                         return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+CEDRXS=%d,%d,\"%s\"", mode, actType, edrxCycleStr.c_str()), 300);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ネットワークが割り当てたeDRXを取得
+                     *
+                     * @param [out] actType アクセステクノロジータイプ。nullptrを指定すると値を代入しません。
+                     *   @arg 0: eDRX無し
+                     *   @arg 4: eMTC
+                     *   @arg 5: NB-IoT
+                     * @param [out] edrxCycle eDRX周期。setEdrx()のedrxCycleと同じ値。無いときは-1。nullptrを指定すると値を代入しません。
+                     * @param [out] pagingTimeWindow ページング時間窓。eMTCは(値+1)*1.28秒、NB-IoTは(値+1)*2.56秒。無いときは-1。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * ネットワークが割り当てたeDRXを取得します。
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 6.11. AT+CEDRXRDP eDRX Read Dynamic Parameters
+                     */
+                    WioCellularResult getEdrxDynamicParameters(int *actType, int *edrxCycle, int *pagingTimeWindow)
+                    {
+                        if (actType)
+                            *actType = 0;
+                        if (edrxCycle)
+                            *edrxCycle = -1;
+                        if (pagingTimeWindow)
+                            *pagingTimeWindow = -1;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            "AT+CEDRXRDP", [actType, edrxCycle, pagingTimeWindow](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+CEDRXRDP: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() < 1) return false;
+                                    if (actType) *actType = std::stoi(parser[0]);
+                                    if (parser.size() >= 3 && parser[2].size() == 4 && edrxCycle) *edrxCycle = std::stoi(parser[2], nullptr, 2);
+                                    if (parser.size() >= 4 && parser[3].size() == 4 && pagingTimeWindow) *pagingTimeWindow = std::stoi(parser[3], nullptr, 2);
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief 電話番号を取得
@@ -228,6 +228,30 @@ namespace wiocellular
                             150000);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief PDPコンテキストを活性化もしくは非活性化
+                     *
+                     * @param [in] cid PDPコンテキストID。
+                     * @param [in] state 状態。
+                     *   @arg 0: 非活性化
+                     *   @arg 1: 活性化
+                     * @return 実行結果。
+                     *
+                     * PDPコンテキストを活性化もしくは非活性化します。
+                     * 処理完了までに最大150秒かかります．
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 8.3. AT+CGACT PDP Context Activate or Deactivate
+                     */
+                    WioCellularResult setPdpContextStatus(int cid, int state)
+                    {
+                        assert(1 <= cid && cid <= 15);
+                        assert(state == 0 || state == 1);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+CGACT=%d,%d", state, cid), 150000);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief EPSネットワーク登録ステータスのURC通知を設定
@@ -251,6 +275,76 @@ namespace wiocellular
                         return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+CEREG=%d", n), 300);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ネットワークが割り当てたPSMのタイマーを取得
+                     *
+                     * @param [out] activeTime アクティブ時間(T3324)[秒]。無いときは-1。nullptrを指定すると値を代入しません。
+                     * @param [out] periodicTau 周期時間(T3412)[秒]。無いときは-1。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * ネットワークが割り当てたPSMのタイマーを取得します。
+                     * 事前にsetEpsNetworkRegistrationStatusUrc(4)を設定してください。
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 8.8. AT+CEREG EPS Network Registration Status
+                     */
+                    WioCellularResult getEpsNetworkRegistrationPsmTimers(int *activeTime, int *periodicTau)
+                    {
+                        if (activeTime)
+                            *activeTime = -1;
+                        if (periodicTau)
+                            *periodicTau = -1;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            "AT+CEREG?", [activeTime, periodicTau](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+CEREG: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() < 2) return false;
+                                    if (parser.size() < 9 || parser[7].size() != 8 || parser[8].size() != 8) return true;
+
+                                    // GPRS Timer 2 (3GPP TS 24.008 10.5.7.4)
+                                    const auto active = std::stoi(parser[7], nullptr, 2);
+                                    static constexpr int ACTIVE_UNITS[] = {2, 60, 360, -1, -1, -1, -1, -1};
+                                    if (activeTime && ACTIVE_UNITS[active >> 5] >= 0) *activeTime = ACTIVE_UNITS[active >> 5] * (active & 0x1f);
+
+                                    // GPRS Timer 3 (3GPP TS 24.008 10.5.7.4a)
+                                    const auto periodic = std::stoi(parser[8], nullptr, 2);
+                                    static constexpr int PERIODIC_UNITS[] = {600, 3600, 36000, 2, 30, 60, 1152000, -1};
+                                    if (periodicTau && PERIODIC_UNITS[periodic >> 5] >= 0) *periodicTau = PERIODIC_UNITS[periodic >> 5] * (periodic & 0x1f);
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief パケットドメインイベントのURC通知を設定
+                     *
+                     * @param [in] mode URC通知設定。
+                     *   @arg 0: URC通知を無効
+                     *   @arg 1: URC通知を有効 データ通信中は破棄
+                     *   @arg 2: URC通知を有効 データ通信中は保留
+                     * @return 実行結果。
+                     *
+                     * PDPコンテキストの活性化、非活性化などのURC通知(+CGEV)を設定します。
+                     *
+                     * 例: "+CGEV: ME PDN ACT 1", "+CGEV: NW PDN DEACT 1", "+CGEV: NW DETACH"
+                     *
+                     * > BG77xA-GL&BG95xA-GL AT Commands Manual @n
+                     * > 8.6. AT+CGEREP Packet Domain Event Reporting
+                     */
+                    WioCellularResult setPacketDomainEventReportingUrc(int mode)
+                    {
+                        assert(0 <= mode && mode <= 2);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+CGEREP=%d", mode), 300);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief EPSネットワーク登録状態を取得
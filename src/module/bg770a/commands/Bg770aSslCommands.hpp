@@ -0,0 +1,444 @@
+/*
+ * Bg770aSslCommands.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef BG770ASSLCOMMANDS_HPP
+#define BG770ASSLCOMMANDS_HPP
+
+#include <map>
+#include "module/at_client/AtParameterParser.hpp"
+#include "internal/Misc.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace module
+    {
+        namespace bg770a
+        {
+            namespace commands
+            {
+
+                /**
+                 * @~Japanese
+                 * @brief Quectel BG770AモジュールのSSLコマンド
+                 *
+                 * @tparam MODULE モジュールのクラス
+                 *
+                 * Quectel BG770AモジュールのSSLコマンドです。
+                 * TLSの処理をモジュールで行います。
+                 */
+                template <typename MODULE>
+                class Bg770aSslCommands
+                {
+                private:
+                    static constexpr int COMMAND_ECHO_TIMEOUT = 10000;
+
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットから受信する最大バイト数
+                     */
+                    static constexpr size_t RECEIVE_SSL_SOCKET_SIZE_MAX = 1500;
+
+                private:
+                    bool UrcSslReceiveAttached_;
+                    std::map<int, bool> UrcSslReceiveNofity_;
+                    std::map<int, bool> UrcSslClosedNofity_;
+
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief コンストラクタ
+                     *
+                     * コンストラクタ。
+                     */
+                    Bg770aSslCommands(void) : UrcSslReceiveAttached_{false},
+                                              UrcSslReceiveNofity_{},
+                                              UrcSslClosedNofity_{}
+                    {
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLのバージョンを設定
+                     *
+                     * @param [in] sslContextId SSLコンテキストID。
+                     * @param [in] version SSLのバージョン。
+                     *   @arg 0: SSL3.0
+                     *   @arg 1: TLS1.0
+                     *   @arg 2: TLS1.1
+                     *   @arg 3: TLS1.2
+                     *   @arg 4: 全て
+                     * @return 実行結果。
+                     *
+                     * SSLのバージョンを設定します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.1. AT+QSSLCFG Configure Parameters of an SSL Context
+                     */
+                    WioCellularResult setSslVersion(int sslContextId, int version)
+                    {
+                        assert(0 <= sslContextId && sslContextId <= 5);
+                        assert(0 <= version && version <= 4);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLCFG=\"sslversion\",%d,%d", sslContextId, version), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLの認証モードを設定
+                     *
+                     * @param [in] sslContextId SSLコンテキストID。
+                     * @param [in] secLevel 認証モード。
+                     *   @arg 0: 認証しない
+                     *   @arg 1: サーバー認証
+                     *   @arg 2: サーバーとクライアント認証
+                     * @return 実行結果。
+                     *
+                     * SSLの認証モードを設定します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.1. AT+QSSLCFG Configure Parameters of an SSL Context
+                     */
+                    WioCellularResult setSslSecurityLevel(int sslContextId, int secLevel)
+                    {
+                        assert(0 <= sslContextId && sslContextId <= 5);
+                        assert(0 <= secLevel && secLevel <= 2);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLCFG=\"seclevel\",%d,%d", sslContextId, secLevel), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLの証明書ファイルを設定
+                     *
+                     * @param [in] sslContextId SSLコンテキストID。
+                     * @param [in] type 証明書の種類。
+                     *   @arg "cacert": 信頼するCA証明書
+                     *   @arg "clientcert": クライアント証明書
+                     *   @arg "clientkey": クライアントの秘密鍵
+                     * @param [in] path モジュールのファイルシステム上のパス。
+                     * @return 実行結果。
+                     *
+                     * SSLの証明書ファイルを設定します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.1. AT+QSSLCFG Configure Parameters of an SSL Context
+                     */
+                    WioCellularResult setSslCertificate(int sslContextId, const std::string &type, const std::string &path)
+                    {
+                        assert(0 <= sslContextId && sslContextId <= 5);
+                        assert(type == "cacert" || type == "clientcert" || type == "clientkey");
+                        assert(!path.empty());
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLCFG=\"%s\",%d,\"%s\"", type.c_str(), sslContextId, path.c_str()), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SNI(server name indication)を設定
+                     *
+                     * @param [in] sslContextId SSLコンテキストID。
+                     * @param [in] enable 有効。
+                     * @return 実行結果。
+                     *
+                     * SNI(server name indication)を設定します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.1. AT+QSSLCFG Configure Parameters of an SSL Context
+                     */
+                    WioCellularResult setSslServerNameIndication(int sslContextId, bool enable)
+                    {
+                        assert(0 <= sslContextId && sslContextId <= 5);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLCFG=\"sni\",%d,%d", sslContextId, enable ? 1 : 0), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLセッション再開を設定
+                     *
+                     * @param [in] sslContextId SSLコンテキストID。
+                     * @param [in] enable 有効。
+                     * @return 実行結果。
+                     *
+                     * SSLセッションキャッシュを使ったセッション再開を設定します。
+                     * 有効にすると、同じサーバーへ接続し直すときにフルハンドシェイクを省略します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.1. AT+QSSLCFG Configure Parameters of an SSL Context
+                     */
+                    WioCellularResult setSslSessionResumption(int sslContextId, bool enable)
+                    {
+                        assert(0 <= sslContextId && sslContextId <= 5);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLCFG=\"session_cache\",%d,%d", sslContextId, enable ? 1 : 0), 300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットをオープン
+                     *
+                     * @param [in] cid PDPコンテキストID。
+                     * @param [in] sslContextId SSLコンテキストID。
+                     * @param [in] clientId クライアントID。
+                     * @param [in] serverAddress サーバーのホスト名もしくはIPアドレス。
+                     * @param [in] serverPort サーバーのポート番号。
+                     * @return 実行結果。
+                     *
+                     * SSLソケットをオープンします。
+                     * バッファアクセスモードでオープンします。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.3. AT+QSSLOPEN Open an SSL Socket to Connect a Remote Server
+                     */
+                    WioCellularResult openSslSocket(int cid, int sslContextId, int clientId, const std::string &serverAddress, int serverPort)
+                    {
+                        assert(1 <= cid && cid <= 5);
+                        assert(0 <= sslContextId && sslContextId <= 5);
+                        assert(0 <= clientId && clientId <= 11);
+                        assert(!serverAddress.empty());
+                        assert(0 <= serverPort && serverPort <= 65535);
+
+                        WioCellularResult result = WioCellularResult::Ok;
+
+                        if (!UrcSslReceiveAttached_)
+                        {
+                            static_cast<MODULE &>(*this).registerUrcHandler([this](const std::string &response) -> bool
+                                                                            {
+                                                                                std::string responseParameter;
+                                                                                if (internal::stringStartsWith(response, "+QSSLURC: \"recv\",", &responseParameter))
+                                                                                {
+                                                                                    const auto clientId = std::stoi(responseParameter);
+                                                                                    printf("---> SSL socket received (clientId=%d)\n", clientId);
+                                                                                    auto nofity = UrcSslReceiveNofity_.find(clientId);
+                                                                                    if (nofity != UrcSslReceiveNofity_.end())
+                                                                                    {
+                                                                                        nofity->second = true;
+                                                                                    }
+                                                                                    return true;
+                                                                                }
+                                                                                if (internal::stringStartsWith(response, "+QSSLURC: \"closed\",", &responseParameter))
+                                                                                {
+                                                                                    const auto clientId = std::stoi(responseParameter);
+                                                                                    printf("---> SSL socket closed (clientId=%d)\n", clientId);
+                                                                                    auto nofity = UrcSslClosedNofity_.find(clientId);
+                                                                                    if (nofity != UrcSslClosedNofity_.end())
+                                                                                    {
+                                                                                        nofity->second = true;
+                                                                                    }
+                                                                                    return true;
+                                                                                }
+                                                                                return false; });
+
+                            UrcSslReceiveAttached_ = true;
+                        }
+                        UrcSslReceiveNofity_[clientId] = false;
+                        UrcSslClosedNofity_[clientId] = false;
+
+                        bool opened = false;
+                        int internalResult;
+                        const auto handler = static_cast<MODULE &>(*this).registerUrcHandler([clientId, &opened, &internalResult](const std::string &response) -> bool
+                                                                                             {
+                                                                                                const std::string prefix = internal::stringFormat("+QSSLOPEN: %d,", clientId);
+                                                                                                if (response.starts_with(prefix))
+                                                                                                {
+                                                                                                    opened = true;
+                                                                                                    internalResult = std::stoi(response.substr(prefix.size()));
+                                                                                                    return true;
+                                                                                                }
+                                                                                                return false; });
+
+                        if ((result = static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLOPEN=%d,%d,%d,\"%s\",%d,0", cid, sslContextId, clientId, serverAddress.c_str(), serverPort), 300)) == WioCellularResult::Ok)
+                        {
+                            constexpr int timeout = 150000;
+                            const auto start = millis();
+                            while (!opened)
+                            {
+                                static_cast<MODULE &>(*this).doWork(timeout - (millis() - start));
+                                if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                                {
+                                    result = WioCellularResult::OpenTimeout;
+                                    break;
+                                }
+                            }
+                        }
+                        static_cast<MODULE &>(*this).unregisterUrcHandler(handler);
+                        if (result != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (internalResult != 0)
+                        {
+                            return WioCellularResult::OpenError;
+                        }
+
+                        return result;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットをクローズ
+                     *
+                     * @param [in] clientId クライアントID。
+                     * @return 実行結果。
+                     *
+                     * SSLソケットをクローズします。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.6. AT+QSSLCLOSE Close an SSL Socket
+                     */
+                    WioCellularResult closeSslSocket(int clientId)
+                    {
+                        assert(0 <= clientId && clientId <= 11);
+
+                        WioCellularResult result = WioCellularResult::Ok;
+
+                        if ((result = static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QSSLCLOSE=%d", clientId), 11000)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+
+                        UrcSslReceiveNofity_.erase(clientId);
+                        UrcSslClosedNofity_.erase(clientId);
+
+                        return result;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットへ送信
+                     *
+                     * @param [in] clientId クライアントID。
+                     * @param [in] data データ。nullptrを指定すると送信しません。
+                     * @param [in] dataSize データサイズ。0を指定すると送信しません。
+                     * @return 実行結果。
+                     *
+                     * SSLソケットへ送信します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.4. AT+QSSLSEND Send Data via SSL Connection
+                     */
+                    WioCellularResult sendSslSocket(int clientId, const void *data, size_t dataSize)
+                    {
+                        assert(0 <= clientId && clientId <= 11);
+
+                        if (!data || dataSize <= 0)
+                        {
+                            return WioCellularResult::Ok;
+                        }
+
+                        return static_cast<MODULE &>(*this).sendCommand(
+                            internal::stringFormat("AT+QSSLSEND=%d,%d", clientId, dataSize), [this, data, dataSize](const std::string &response) -> bool
+                            {
+                                if (response == "> ")
+                                {
+                                    static_cast<MODULE &>(*this).writeBinary(data, dataSize);
+                                    static_cast<MODULE &>(*this).readBinaryDiscard(dataSize, COMMAND_ECHO_TIMEOUT);
+                                    return true;
+                                }
+                                return false; },
+                            120000);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットの受信通知を取得
+                     *
+                     * @param [in] clientId クライアントID。
+                     * @retval true 受信通知あり
+                     * @retval false 受信通知なし
+                     *
+                     * 前回のreceiveSslSocket()以降に、受信通知のURC(+QSSLURC: "recv")があったかを取得します。
+                     * ATコマンドは送信しません。
+                     */
+                    bool isSslSocketReceiveNotified(int clientId) const
+                    {
+                        assert(0 <= clientId && clientId <= 11);
+
+                        const auto nofity = UrcSslReceiveNofity_.find(clientId);
+                        return nofity != UrcSslReceiveNofity_.end() && nofity->second;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットの切断通知を取得
+                     *
+                     * @param [in] clientId クライアントID。
+                     * @retval true 切断通知あり
+                     * @retval false 切断通知なし
+                     *
+                     * リモートからの切断通知のURC(+QSSLURC: "closed")があったかを取得します。
+                     * ATコマンドは送信しません。
+                     */
+                    bool isSslSocketClosedNotified(int clientId) const
+                    {
+                        assert(0 <= clientId && clientId <= 11);
+
+                        const auto nofity = UrcSslClosedNofity_.find(clientId);
+                        return nofity != UrcSslClosedNofity_.end() && nofity->second;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief SSLソケットから受信
+                     *
+                     * @param [in] clientId クライアントID。
+                     * @param [in,out] data データ。nullptrを指定すると読み捨てます。
+                     * @param [in] dataSize データサイズ。0を指定すると受信しません。
+                     * @param [out] readDataSize 受信したデータサイズ。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * SSLソケットから受信します。
+                     * 受信したデータが無いときは*readDataSize=0を返します。
+                     *
+                     * > BG95&BG77&BG600L Series SSL Application Note @n
+                     * > 2.2.5. AT+QSSLRECV Receive Data via SSL Connection
+                     */
+                    WioCellularResult receiveSslSocket(int clientId, void *data, size_t dataSize, size_t *readDataSize)
+                    {
+                        assert(0 <= clientId && clientId <= 11);
+
+                        if (dataSize <= 0)
+                        {
+                            return WioCellularResult::Ok;
+                        }
+                        if (readDataSize)
+                            *readDataSize = 0;
+
+                        UrcSslReceiveNofity_[clientId] = false;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            internal::stringFormat("AT+QSSLRECV=%d,%d", clientId, dataSize), [this, data, dataSize, readDataSize](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QSSLRECV: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() < 1) return false;
+                                    const size_t actualDataSize = std::stoi(parser[0]);
+                                    assert(actualDataSize <= dataSize);
+                                    if (actualDataSize >= 1)
+                                    {
+                                        if (!static_cast<MODULE &>(*this).readBinary(data, actualDataSize, 120000))
+                                        {
+                                            return false;
+                                        }
+                                    }
+                                    if (readDataSize) *readDataSize = actualDataSize;
+                                    return true;
+                                }
+                                return false; },
+                            120000);
+                    }
+                };
+
+            }
+        }
+    }
+}
+
+#endif // BG770ASSLCOMMANDS_HPP
@@ -7,8 +7,12 @@
 #ifndef BG770ATCPIPCOMMANDS_HPP
 #define BG770ATCPIPCOMMANDS_HPP
 
+#include <algorithm>
 #include <bitset>
+#include <functional>
+#include <initializer_list>
 #include <map>
+#include <queue>
 #include <vector>
 #include "module/at_client/AtParameterParser.hpp"
 #include "internal/Misc.hpp"
@@ -44,9 +48,55 @@ namespace wiocellular
                      */
                     static constexpr size_t RECEIVE_SOCKET_SIZE_MAX = 1500;
 
+                public:
+                    /**
+                     * @~Japanese
+                     * @brief TCPサーバーの接続
+                     */
+                    struct SocketIncoming
+                    {
+                        /**
+                         * @~Japanese
+                         * @brief 接続ID
+                         * * 0~11
+                         */
+                        int connectId;
+                        /**
+                         * @~Japanese
+                         * @brief リモートのIPアドレス
+                         */
+                        std::string remoteIpAddress;
+                        /**
+                         * @~Japanese
+                         * @brief リモートのポート番号
+                         * * 0~65535
+                         */
+                        int remotePort;
+                    };
+
+                    /**
+                     * @~Japanese
+                     * @brief 送信データの断片
+                     */
+                    struct SocketFragment
+                    {
+                        /**
+                         * @~Japanese
+                         * @brief データ
+                         */
+                        const void *data;
+                        /**
+                         * @~Japanese
+                         * @brief データサイズ
+                         */
+                        size_t dataSize;
+                    };
+
                 private:
                     bool UrcSocketReceiveAttached_;
                     std::map<int, bool> UrcSocketReceiveNofity_;
+                    std::map<int, bool> UrcSocketClosedNofity_;
+                    std::map<int, std::queue<SocketIncoming>> UrcSocketIncoming_;
 
                 public:
                     /**
@@ -136,7 +186,9 @@ namespace wiocellular
                      * コンストラクタ。
                      */
                     Bg770aTcpipCommands(void) : UrcSocketReceiveAttached_{false},
-                                                UrcSocketReceiveNofity_{}
+                                                UrcSocketReceiveNofity_{},
+                                                UrcSocketClosedNofity_{},
+                                                UrcSocketIncoming_{}
                     {
                     }
 
@@ -184,11 +236,48 @@ namespace wiocellular
                                                                                     }
                                                                                     return true;
                                                                                 }
+                                                                                if (internal::stringStartsWith(response, "+QIURC: \"closed\",", &responseParameter))
+                                                                                {
+                                                                                    const auto connectId = std::stoi(responseParameter);
+                                                                                    printf("---> Socket closed (connectId=%d)\n", connectId);
+                                                                                    auto nofity = UrcSocketClosedNofity_.find(connectId);
+                                                                                    if (nofity != UrcSocketClosedNofity_.end())
+                                                                                    {
+                                                                                        nofity->second = true;
+                                                                                    }
+                                                                                    return true;
+                                                                                }
+                                                                                if (internal::stringStartsWith(response, "+QIURC: \"incoming\",", &responseParameter))
+                                                                                {
+                                                                                    at_client::AtParameterParser parser{responseParameter};
+                                                                                    if (parser.size() != 4) return false;
+                                                                                    const auto connectId = std::stoi(parser[0]);
+                                                                                    const auto serverId = std::stoi(parser[1]);
+                                                                                    printf("---> Socket incoming (connectId=%d, serverId=%d)\n", connectId, serverId);
+                                                                                    auto incoming = UrcSocketIncoming_.find(serverId);
+                                                                                    if (incoming != UrcSocketIncoming_.end())
+                                                                                    {
+                                                                                        UrcSocketReceiveNofity_[connectId] = false;
+                                                                                        UrcSocketClosedNofity_[connectId] = false;
+                                                                                        incoming->second.push({connectId, parser[2], std::stoi(parser[3])});
+                                                                                    }
+                                                                                    return true;
+                                                                                }
+                                                                                if (response == "+QIURC: \"incoming full\"")
+                                                                                {
+                                                                                    printf("---> Socket incoming full\n");
+                                                                                    return true;
+                                                                                }
                                                                                 return false; });
 
                             UrcSocketReceiveAttached_ = true;
                         }
                         UrcSocketReceiveNofity_[connectId] = false;
+                        UrcSocketClosedNofity_[connectId] = false;
+                        if (serviceType == "TCP LISTENER")
+                        {
+                            UrcSocketIncoming_[connectId] = {};
+                        }
 
                         bool opened = false;
                         int internalResult;
@@ -254,10 +343,75 @@ namespace wiocellular
                         }
 
                         UrcSocketReceiveNofity_.erase(connectId);
+                        UrcSocketClosedNofity_.erase(connectId);
+                        UrcSocketIncoming_.erase(connectId);
 
                         return result;
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief TCPサーバーの接続を取り出し
+                     *
+                     * @param [in] serverId サーバー（TCP LISTENER）の接続ID。
+                     * @param [out] incoming TCPサーバーの接続。nullptrを指定すると値を代入しません。
+                     * @retval true 接続あり
+                     * @retval false 接続なし
+                     *
+                     * URC(+QIURC: "incoming")で通知されたTCPサーバーの接続を、受け付けた順に取り出します。
+                     * ATコマンドは送信しません。
+                     * 取り出した接続は、接続IDを使ってsendSocket()やreceiveSocket()、closeSocket()で操作します。
+                     */
+                    bool acceptSocket(int serverId, SocketIncoming *incoming)
+                    {
+                        assert(0 <= serverId && serverId <= 11);
+
+                        auto it = UrcSocketIncoming_.find(serverId);
+                        if (it == UrcSocketIncoming_.end() || it->second.empty())
+                        {
+                            return false;
+                        }
+
+                        if (incoming)
+                            *incoming = it->second.front();
+                        it->second.pop();
+
+                        return true;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief TCPキープアライブを設定
+                     *
+                     * @param [in] enable 有効。
+                     * @param [in] idleTime キープアライブを開始するまでの無通信時間[分]。
+                     *   @arg 1~120
+                     * @param [in] interval キープアライブの送信間隔[秒]。
+                     *   @arg 25~100
+                     * @param [in] probeCount 切断と判断するまでの再送回数。
+                     *   @arg 3~10
+                     * @return 実行結果。
+                     *
+                     * TCPキープアライブを設定します。
+                     * 設定した後にオープンしたソケットに適用されます。
+                     *
+                     * > BG770A-GL&BG95xA-GL TCP/IP Application Note @n
+                     * > 2.3.3. AT+QICFG Configure Optional Parameters
+                     */
+                    WioCellularResult setTcpKeepalive(bool enable, int idleTime, int interval, int probeCount)
+                    {
+                        if (!enable)
+                        {
+                            return static_cast<MODULE &>(*this).executeCommand("AT+QICFG=\"tcp/keepalive\",0", 300);
+                        }
+
+                        assert(1 <= idleTime && idleTime <= 120);
+                        assert(25 <= interval && interval <= 100);
+                        assert(3 <= probeCount && probeCount <= 10);
+
+                        return static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QICFG=\"tcp/keepalive\",1,%d,%d,%d", idleTime, interval, probeCount), 300);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief ソケットサービスステータスを取得
@@ -345,6 +499,86 @@ namespace wiocellular
                         return WioCellularResult::Ok;
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ホスト名からIPアドレスを取得
+                     *
+                     * @param [in] cid PDPコンテキストID。
+                     * @param [in] hostName ホスト名。
+                     * @param [out] ipAddresses IPアドレス。nullptrを指定すると値を代入しません。
+                     * @param [out] ttl DNSのTTL(time to live)[秒]。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * DNSサーバーに問い合わせて、ホスト名からIPアドレスを取得します。
+                     * 結果はURC(+QIURC: "dnsgip")で通知されるので、通知を待ちます。
+                     *
+                     * > BG770A-GL&BG95xA-GL TCP/IP Application Note @n
+                     * > 2.3.13. AT+QIDNSGIP Get IP Address by Domain Name
+                     */
+                    WioCellularResult getIpAddressByHostName(int cid, const std::string &hostName, std::vector<std::string> *ipAddresses, int *ttl)
+                    {
+                        assert(1 <= cid && cid <= 5);
+                        assert(!hostName.empty());
+
+                        if (ipAddresses)
+                            ipAddresses->clear();
+                        if (ttl)
+                            *ttl = -1;
+
+                        WioCellularResult result = WioCellularResult::Ok;
+
+                        int internalResult = -1;
+                        int ipCount = -1;
+                        const auto handler = static_cast<MODULE &>(*this).registerUrcHandler([&internalResult, &ipCount, ipAddresses, ttl](const std::string &response) -> bool
+                                                                                             {
+                                                                                                std::string responseParameter;
+                                                                                                if (internal::stringStartsWith(response, "+QIURC: \"dnsgip\",", &responseParameter))
+                                                                                                {
+                                                                                                    at_client::AtParameterParser parser{responseParameter};
+                                                                                                    if (ipCount < 0)
+                                                                                                    {
+                                                                                                        if (parser.size() < 1) return false;
+                                                                                                        internalResult = std::stoi(parser[0]);
+                                                                                                        ipCount = internalResult == 0 && parser.size() >= 2 ? std::stoi(parser[1]) : 0;
+                                                                                                        if (internalResult == 0 && parser.size() >= 3 && ttl) *ttl = std::stoi(parser[2]);
+                                                                                                    }
+                                                                                                    else
+                                                                                                    {
+                                                                                                        if (parser.size() != 1) return false;
+                                                                                                        if (ipAddresses) ipAddresses->push_back(parser[0]);
+                                                                                                        --ipCount;
+                                                                                                    }
+                                                                                                    return true;
+                                                                                                }
+                                                                                                return false; });
+
+                        if ((result = static_cast<MODULE &>(*this).executeCommand(internal::stringFormat("AT+QIDNSGIP=%d,\"%s\"", cid, hostName.c_str()), 300)) == WioCellularResult::Ok)
+                        {
+                            constexpr int timeout = 60000;
+                            const auto start = millis();
+                            while (ipCount != 0)
+                            {
+                                static_cast<MODULE &>(*this).doWork(timeout - (millis() - start));
+                                if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                                {
+                                    result = WioCellularResult::DnsTimeout;
+                                    break;
+                                }
+                            }
+                        }
+                        static_cast<MODULE &>(*this).unregisterUrcHandler(handler);
+                        if (result != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                        if (internalResult != 0)
+                        {
+                            return WioCellularResult::DnsError;
+                        }
+
+                        return result;
+                    }
+
                     /**
                      * @~Japanese
                      * @brief ソケットへ送信
@@ -381,6 +615,46 @@ namespace wiocellular
                             120000);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ソケットへ送信（宛先指定）
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [in] remoteIpAddress 宛先のIPアドレス。
+                     * @param [in] remotePort 宛先のポート番号。
+                     * @param [in] data データ。nullptrを指定すると送信しません。
+                     * @param [in] dataSize データサイズ。0を指定すると送信しません。
+                     * @return 実行結果。
+                     *
+                     * サービスタイプが"UDP SERVICE"のソケットから、指定した宛先へ送信します。
+                     *
+                     * > BG770A-GL&BG95xA-GL TCP/IP Application Note @n
+                     * > 2.3.8. AT+QISEND Send Data
+                     */
+                    WioCellularResult sendSocket(int connectId, const std::string &remoteIpAddress, int remotePort, const void *data, size_t dataSize)
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+                        assert(!remoteIpAddress.empty());
+                        assert(0 <= remotePort && remotePort <= 65535);
+
+                        if (!data || dataSize <= 0)
+                        {
+                            return WioCellularResult::Ok;
+                        }
+
+                        return static_cast<MODULE &>(*this).sendCommand(
+                            internal::stringFormat("AT+QISEND=%d,%d,\"%s\",%d", connectId, dataSize, remoteIpAddress.c_str(), remotePort), [this, data, dataSize](const std::string &response) -> bool
+                            {
+                                if (response == "> ")
+                                {
+                                    static_cast<MODULE &>(*this).writeBinary(data, dataSize);
+                                    static_cast<MODULE &>(*this).readBinaryDiscard(dataSize, COMMAND_ECHO_TIMEOUT);
+                                    return true;
+                                }
+                                return false; },
+                            120000);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief ソケットへ送信
@@ -396,6 +670,222 @@ namespace wiocellular
                         return sendSocket(connectId, data.data(), data.size());
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ソケットへ送信（断片）
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [in] fragments データの断片の配列。
+                     * @param [in] fragmentCount データの断片の数。
+                     * @return 実行結果。
+                     *
+                     * 複数のデータの断片を連結せずに、1回のAT+QISENDで送信します。
+                     * プロンプトの後に、断片を順にwriteBinary()で書き込みます。
+                     * 断片の合計サイズが0のときは送信しません。
+                     *
+                     * > BG770A-GL&BG95xA-GL TCP/IP Application Note @n
+                     * > 2.3.8. AT+QISEND Send Data
+                     */
+                    WioCellularResult sendSocketFragments(int connectId, const SocketFragment *fragments, size_t fragmentCount)
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+                        assert(fragments || fragmentCount == 0);
+
+                        size_t dataSize = 0;
+                        for (size_t i = 0; i < fragmentCount; ++i)
+                        {
+                            assert(fragments[i].data || fragments[i].dataSize == 0);
+                            dataSize += fragments[i].dataSize;
+                        }
+                        if (dataSize <= 0)
+                        {
+                            return WioCellularResult::Ok;
+                        }
+                        assert(dataSize <= 1460);
+
+                        return static_cast<MODULE &>(*this).sendCommand(
+                            internal::stringFormat("AT+QISEND=%d,%d", connectId, dataSize), [this, fragments, fragmentCount, dataSize](const std::string &response) -> bool
+                            {
+                                if (response == "> ")
+                                {
+                                    for (size_t i = 0; i < fragmentCount; ++i)
+                                    {
+                                        if (fragments[i].dataSize >= 1) static_cast<MODULE &>(*this).writeBinary(fragments[i].data, fragments[i].dataSize);
+                                    }
+                                    static_cast<MODULE &>(*this).readBinaryDiscard(dataSize, COMMAND_ECHO_TIMEOUT);
+                                    return true;
+                                }
+                                return false; },
+                            120000);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ソケットへ送信（断片）
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [in] fragments データの断片。例: {{header, headerSize}, {payload, payloadSize}}
+                     * @return 実行結果。
+                     *
+                     * 複数のデータの断片を連結せずに、1回のAT+QISENDで送信します。
+                     */
+                    WioCellularResult sendSocketFragments(int connectId, std::initializer_list<SocketFragment> fragments)
+                    {
+                        return sendSocketFragments(connectId, fragments.begin(), fragments.size());
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ソケットの送信状況を取得
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [out] totalSendSize 送信したデータサイズの合計。nullptrを指定すると値を代入しません。
+                     * @param [out] ackedSize 相手からACKを受けたデータサイズ。nullptrを指定すると値を代入しません。
+                     * @param [out] unackedSize 相手からACKを受けていないデータサイズ。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * TCPのソケットの送信状況を取得します。
+                     * sendSocket()はモジュールの送信バッファに入った時点で戻るので、相手に届いたかはこの値で確認します。
+                     *
+                     * > BG770A-GL&BG95xA-GL TCP/IP Application Note @n
+                     * > 2.3.8. AT+QISEND Send Data
+                     */
+                    WioCellularResult getSocketSendStatus(int connectId, size_t *totalSendSize, size_t *ackedSize, size_t *unackedSize)
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            internal::stringFormat("AT+QISEND=%d,0", connectId), [totalSendSize, ackedSize, unackedSize](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QISEND: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() != 3) return false;
+                                    if (totalSendSize) *totalSendSize = std::stoul(parser[0]);
+                                    if (ackedSize) *ackedSize = std::stoul(parser[1]);
+                                    if (unackedSize) *unackedSize = std::stoul(parser[2]);
+                                    return true;
+                                }
+                                return false; },
+                            300);
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief 送信したデータのACKを待つ
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [in] timeout タイムアウト時間[ミリ秒]。-1のときは無制限。
+                     * @return 実行結果。
+                     *
+                     * 送信したデータが全て相手からACKを受けるまで待ちます。
+                     * 待っている間もURCを処理します。
+                     */
+                    WioCellularResult waitUntilAcked(int connectId, int timeout)
+                    {
+                        constexpr int POLLING_INTERVAL = 500;
+
+                        WioCellularResult result;
+
+                        const auto start = millis();
+                        while (true)
+                        {
+                            size_t unackedSize;
+                            if ((result = getSocketSendStatus(connectId, nullptr, nullptr, &unackedSize)) != WioCellularResult::Ok)
+                            {
+                                return result;
+                            }
+                            if (unackedSize == 0)
+                            {
+                                return WioCellularResult::Ok;
+                            }
+                            if (isSocketClosedNotified(connectId))
+                            {
+                                return WioCellularResult::CommandRejected;
+                            }
+                            if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                            {
+                                return WioCellularResult::ReceiveTimeout;
+                            }
+                            const int remain = timeout >= 0 ? static_cast<int>(timeout - (millis() - start)) : POLLING_INTERVAL;
+                            static_cast<MODULE &>(*this).doWorkUntil(std::min(remain, POLLING_INTERVAL));
+                        }
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ソケットへ流量を制御して送信
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [in,out] buffer 送信に使うバッファ。
+                     * @param [in] bufferSize バッファのサイズ。1回のAT+QISENDで送信する最大サイズ。
+                     * @param [in] source バッファへデータを書き込む関数。書き込んだサイズを返し、0を返すと終了します。
+                     * @param [in] window ACKを受けていないデータの上限[バイト]。
+                     * @param [in] timeout ACKを待つタイムアウト時間[ミリ秒]。-1のときは無制限。
+                     * @param [out] sentSize 送信したデータサイズ。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * sourceが返すデータを、ACKを受けていないデータがwindowを超えないように送信します。
+                     * 送信したサイズから未ACKのデータサイズを見積もり、windowを超えそうなときだけAT+QISEND=<connectId>,0で問い合わせて待ちます。
+                     * 最後に全てのデータのACKを待ちます。
+                     */
+                    WioCellularResult sendSocketStream(int connectId, void *buffer, size_t bufferSize, const std::function<size_t(void *data, size_t dataSize)> &source, size_t window, int timeout, size_t *sentSize)
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+                        assert(buffer);
+                        assert(1 <= bufferSize && bufferSize <= 1460);
+                        assert(source);
+                        assert(window >= bufferSize);
+
+                        if (sentSize)
+                            *sentSize = 0;
+
+                        WioCellularResult result;
+
+                        size_t unackedSize = 0; // Upper bound of unacknowledged data
+                        while (true)
+                        {
+                            const auto size = source(buffer, bufferSize);
+                            if (size == 0)
+                                break;
+
+                            if (unackedSize + size > window)
+                            {
+                                const auto start = millis();
+                                while (true)
+                                {
+                                    if ((result = getSocketSendStatus(connectId, nullptr, nullptr, &unackedSize)) != WioCellularResult::Ok)
+                                    {
+                                        return result;
+                                    }
+                                    if (unackedSize + size <= window)
+                                        break;
+                                    if (isSocketClosedNotified(connectId))
+                                    {
+                                        return WioCellularResult::CommandRejected;
+                                    }
+                                    if (timeout >= 0 && millis() - start >= static_cast<uint32_t>(timeout))
+                                    {
+                                        return WioCellularResult::ReceiveTimeout;
+                                    }
+                                    const int remain = timeout >= 0 ? static_cast<int>(timeout - (millis() - start)) : 100;
+                                    static_cast<MODULE &>(*this).doWorkUntil(std::min(remain, 100));
+                                }
+                            }
+
+                            if ((result = sendSocket(connectId, buffer, size)) != WioCellularResult::Ok)
+                            {
+                                return result;
+                            }
+                            unackedSize += size;
+                            if (sentSize)
+                                *sentSize += size;
+                        }
+
+                        return waitUntilAcked(connectId, timeout);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief ソケットから未読のデータサイズを取得
@@ -431,6 +921,45 @@ namespace wiocellular
                             120000);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ソケットの受信通知を取得
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @retval true 受信通知あり
+                     * @retval false 受信通知なし
+                     *
+                     * 前回のreceiveSocket()以降に、受信通知のURC(+QIURC: "recv")があったかを取得します。
+                     * ATコマンドは送信しません。
+                     */
+                    bool isSocketReceiveNotified(int connectId) const
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+
+                        const auto nofity = UrcSocketReceiveNofity_.find(connectId);
+                        return nofity != UrcSocketReceiveNofity_.end() && nofity->second;
+                    }
+
+                    /**
+                     * @~Japanese
+                     * @brief ソケットの切断通知を取得
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @retval true 切断通知あり
+                     * @retval false 切断通知なし
+                     *
+                     * リモートからの切断通知のURC(+QIURC: "closed")があったかを取得します。
+                     * 切断通知があったソケットもcloseSocket()でクローズする必要があります。
+                     * ATコマンドは送信しません。
+                     */
+                    bool isSocketClosedNotified(int connectId) const
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+
+                        const auto nofity = UrcSocketClosedNofity_.find(connectId);
+                        return nofity != UrcSocketClosedNofity_.end() && nofity->second;
+                    }
+
                     /**
                      * @~Japanese
                      * @brief ソケットから受信
@@ -485,6 +1014,67 @@ namespace wiocellular
                             120000);
                     }
 
+                    /**
+                     * @~Japanese
+                     * @brief ソケットから受信（送信元取得）
+                     *
+                     * @param [in] connectId 接続ID。
+                     * @param [in,out] data データ。nullptrを指定すると読み捨てます。
+                     * @param [in] dataSize データサイズ。0を指定すると受信しません。
+                     * @param [out] readDataSize 受信したデータサイズ。nullptrを指定すると値を代入しません。
+                     * @param [out] remoteIpAddress 送信元のIPアドレス。nullptrを指定すると値を代入しません。
+                     * @param [out] remotePort 送信元のポート番号。nullptrを指定すると値を代入しません。
+                     * @return 実行結果。
+                     *
+                     * サービスタイプが"UDP SERVICE"のソケットから、1データグラムを受信します。
+                     * 受信したデータが無いときは*readDataSize=0を返します。
+                     *
+                     * > BG770A-GL&BG95xA-GL TCP/IP Application Note @n
+                     * > 2.3.9. AT+QIRD Retrieve the Received TCP/IP Data
+                     */
+                    WioCellularResult receiveSocket(int connectId, void *data, size_t dataSize, size_t *readDataSize, std::string *remoteIpAddress, int *remotePort)
+                    {
+                        assert(0 <= connectId && connectId <= 11);
+
+                        if (dataSize <= 0)
+                        {
+                            return WioCellularResult::Ok;
+                        }
+                        if (readDataSize)
+                            *readDataSize = 0;
+                        if (remoteIpAddress)
+                            remoteIpAddress->clear();
+                        if (remotePort)
+                            *remotePort = -1;
+
+                        UrcSocketReceiveNofity_[connectId] = false;
+
+                        return static_cast<MODULE &>(*this).queryCommand(
+                            internal::stringFormat("AT+QIRD=%d,%d", connectId, dataSize), [this, data, dataSize, readDataSize, remoteIpAddress, remotePort](const std::string &response) -> bool
+                            {
+                                std::string responseParameter;
+                                if (internal::stringStartsWith(response, "+QIRD: ", &responseParameter))
+                                {
+                                    at_client::AtParameterParser parser{responseParameter};
+                                    if (parser.size() < 1) return false;
+                                    const size_t actualDataSize = std::stoi(parser[0]);
+                                    assert(actualDataSize <= dataSize);
+                                    if (actualDataSize >= 1)
+                                    {
+                                        if (!static_cast<MODULE &>(*this).readBinary(data, actualDataSize, 120000))
+                                        {
+                                            return false;
+                                        }
+                                    }
+                                    if (readDataSize) *readDataSize = actualDataSize;
+                                    if (parser.size() >= 3 && remoteIpAddress) *remoteIpAddress = parser[1];
+                                    if (parser.size() >= 3 && remotePort) *remotePort = std::stoi(parser[2]);
+                                    return true;
+                                }
+                                return false; },
+                            120000);
+                    }
+
                     /**
                      * @~Japanese
                      * @brief ソケットから受信
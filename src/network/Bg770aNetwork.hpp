@@ -7,6 +7,8 @@
 #ifndef BG770ANETWORK_HPP
 #define BG770ANETWORK_HPP
 
+#include "internal/Crc32.hpp"
+
 namespace wiocellular
 {
     namespace network
@@ -82,6 +84,63 @@ namespace wiocellular
                 Unknown,
             };
 
+            /**
+             * @~Japanese
+             * @brief 復旧の処理
+             */
+            enum class RecoveryAction
+            {
+                /**
+                 * @~Japanese
+                 * @brief なし
+                 */
+                None,
+                /**
+                 * @~Japanese
+                 * @brief PDPコンテキストを活性化
+                 */
+                ReactivatePdp,
+                /**
+                 * @~Japanese
+                 * @brief 機能を停止して再開(AT+CFUN=0、AT+CFUN=1)
+                 */
+                RestartFunctionality,
+                /**
+                 * @~Japanese
+                 * @brief モジュールをリセット
+                 */
+                ResetModem,
+            };
+
+            /**
+             * @~Japanese
+             * @brief 接続できた周波数バンド
+             */
+            struct BandHint
+            {
+                /**
+                 * @~Japanese
+                 * @brief アクセステクノロジー
+                 * * -1: 無し
+                 * * 0: LTE-M
+                 * * 1: NB-IoT
+                 */
+                int act;
+                /**
+                 * @~Japanese
+                 * @brief 周波数バンド
+                 * * 0: 無し
+                 * * 1~: LTE Bn
+                 */
+                int band;
+                /**
+                 * @~Japanese
+                 * @brief チャネル番号(EARFCN)
+                 * * -1: 無し
+                 */
+                int channel;
+            };
+
         public:
             /**
              * @~Japanese
@@ -101,6 +160,44 @@ namespace wiocellular
              */
             std::function<void(const char *file, int line)> abortHandler;
 
+            /**
+             * @~Japanese
+             * @brief 設定のハッシュを読み込むハンドラ
+             *
+             * 前回begin()で適用した設定のハッシュを、FeRAMなどから読み込んで*configHashに代入し、trueを返します。
+             * 保存していないときはfalseを返します。
+             * saveConfigHashと一緒に設定すると、ハッシュが一致したときにbegin()で設定の確認を省略します。
+             */
+            std::function<bool(uint32_t *configHash)> loadConfigHash;
+
+            /**
+             * @~Japanese
+             * @brief 設定のハッシュを保存するハンドラ
+             *
+             * begin()で設定を適用したときに、設定とIMEI、ファームウェアのレビジョンのハッシュを渡します。FeRAMなどに保存してください。
+             * モジュールの設定を手動で変更したり、工場出荷時に戻したときは、保存したハッシュを消してください。
+             */
+            std::function<void(uint32_t configHash)> saveConfigHash;
+
+            /**
+             * @~Japanese
+             * @brief 接続できた周波数バンドを読み込むハンドラ
+             *
+             * saveBandHintで保存した値を、FeRAMなどから読み込んで*hintに代入し、trueを返します。
+             * 保存していないときはfalseを返します。
+             * saveBandHintと一緒に設定すると、begin()で周波数バンドを前回接続できたバンドに絞って、ネットワーク検索を短くします。
+             */
+            std::function<bool(BandHint *hint)> loadBandHint;
+
+            /**
+             * @~Japanese
+             * @brief 接続できた周波数バンドを保存するハンドラ
+             *
+             * supervise()で、接続できた周波数バンドが変わったときに呼び出します。FeRAMなどに保存してください。
+             * 絞ったバンドで接続できずに元に戻したときは、hint.band=0で呼び出します。
+             */
+            std::function<void(const BandHint &hint)> saveBandHint;
+
             /**
              * @~Japanese
              * @brief ネットワークの設定
@@ -169,10 +266,286 @@ namespace wiocellular
                 std::string apn;
             } config;
 
+            /**
+             * @~Japanese
+             * @brief 復旧の設定
+             */
+            struct
+            {
+                /**
+                 * @~Japanese
+                 * @brief 復旧の有効
+                 *
+                 * 既定はfalseです。supervise()で復旧するときはtrueにしてください。
+                 */
+                bool enable;
+                /**
+                 * @~Japanese
+                 * @brief 最初の再試行間隔[ミリ秒]
+                 *
+                 * 復旧の処理をする度に2倍にします。
+                 */
+                uint32_t initialBackoff;
+                /**
+                 * @~Japanese
+                 * @brief 最大の再試行間隔[ミリ秒]
+                 */
+                uint32_t maxBackoff;
+                /**
+                 * @~Japanese
+                 * @brief ネットワーク検索を待つ時間[ミリ秒]
+                 *
+                 * ネットワーク検索中は、この時間が経過するまで復旧の処理をしません。
+                 */
+                uint32_t searchTimeout;
+                /**
+                 * @~Japanese
+                 * @brief PDPコンテキストを活性化する回数
+                 */
+                int reactivatePdpCount;
+                /**
+                 * @~Japanese
+                 * @brief 機能を停止して再開する回数
+                 */
+                int restartFunctionalityCount;
+                /**
+                 * @~Japanese
+                 * @brief モジュールのリセット後に起動を待つ時間[ミリ秒]
+                 */
+                int powerOnTimeout;
+            } recovery;
+
+            /**
+             * @~Japanese
+             * @brief 周波数バンドの学習の設定
+             */
+            struct
+            {
+                /**
+                 * @~Japanese
+                 * @brief 絞った周波数バンドで接続を待つ時間[ミリ秒]
+                 *
+                 * 接続できないときは、config.ltemBandとconfig.nbiotBandに戻します。
+                 */
+                uint32_t fallbackTimeout;
+            } bandLearning;
+
         private:
+            static constexpr uint32_t PDP_INACTIVE_RECHECK_INTERVAL = 5000; // [ms]
+
             int epsRegistrationStatus;
+            bool PdpStateValid_;
+            uint32_t PdpStateTime_;
+            std::string PdpAddress_;
+
+            bool RecoveryFailing_;
+            uint32_t RecoveryFailureTime_;
+            uint32_t RecoveryNextTime_;
+            uint32_t RecoveryBackoff_;
+            int RecoveryAttempt_;
+            RecoveryAction LastRecoveryAction_;
+            int RecoveryCount_;
+
+            BandHint BandHint_;
+            bool BandNarrowed_;
+            bool BandLearned_;
+            uint32_t BeginTime_;
 
         private:
+            uint32_t calcConfigHash(const std::string &ltemBand, const std::string &nbiotBand, const std::string &imei, const std::string &revision) const
+            {
+                const int searchAccessTechnology = static_cast<int>(config.searchAccessTechnology);
+                uint32_t hash = internal::crc32(&searchAccessTechnology, sizeof(searchAccessTechnology));
+                hash = internal::crc32(ltemBand.c_str(), ltemBand.size() + 1, hash);
+                hash = internal::crc32(nbiotBand.c_str(), nbiotBand.size() + 1, hash);
+                hash = internal::crc32(&config.pdpContextId, sizeof(config.pdpContextId), hash);
+                hash = internal::crc32(config.apn.c_str(), config.apn.size() + 1, hash);
+                hash = internal::crc32(imei.c_str(), imei.size() + 1, hash);
+                hash = internal::crc32(revision.c_str(), revision.size() + 1, hash);
+
+                return hash;
+            }
+
+            void invalidatePdpState(void)
+            {
+                PdpStateValid_ = false;
+            }
+
+            void setPdpDeactivated(void)
+            {
+                PdpStateValid_ = true;
+                PdpStateTime_ = millis();
+                PdpAddress_.clear();
+            }
+
+            bool processPdpUrc(const std::string &response)
+            {
+                std::string responseParameter;
+                if (internal::stringStartsWith(response, "+CGEV: ", &responseParameter))
+                {
+                    // "ME PDN ACT <cid>", "NW PDN DEACT <cid>", "NW DETACH", ...
+                    const auto cidPos = responseParameter.find_last_of(' ');
+                    const auto cid = cidPos != std::string::npos && isdigit(responseParameter[cidPos + 1]) ? std::stoi(responseParameter.substr(cidPos + 1)) : -1;
+                    if (responseParameter.find("DETACH") != std::string::npos)
+                    {
+                        setPdpDeactivated();
+                    }
+                    else if (cid == config.pdpContextId && responseParameter.find("DEACT") != std::string::npos)
+                    {
+                        setPdpDeactivated();
+                    }
+                    else if (cid == config.pdpContextId && responseParameter.find("ACT") != std::string::npos)
+                    {
+                        invalidatePdpState();
+                    }
+                    return true;
+                }
+                if (internal::stringStartsWith(response, "+QIURC: \"closed\",", &responseParameter))
+                {
+                    // Closed sockets may be caused by lost connectivity; leave the URC to the socket handler
+                    invalidatePdpState();
+                    return false;
+                }
+                if (internal::stringStartsWith(response, "+QIURC: \"pdpdeact\",", &responseParameter))
+                {
+                    if (std::stoi(responseParameter) == config.pdpContextId)
+                    {
+                        setPdpDeactivated();
+                    }
+                    return true;
+                }
+
+                return false;
+            }
+
+            WioCellularResult enableNotification(void)
+            {
+                WioCellularResult result;
+
+                if ((result = WioCellular.setEpsNetworkRegistrationStatusUrc(1)) != WioCellularResult::Ok)
+                    return result;
+                if ((result = WioCellular.setPacketDomainEventReportingUrc(1)) != WioCellularResult::Ok)
+                    return result;
+                if ((result = WioCellular.getEpsNetworkRegistrationState(&epsRegistrationStatus)) != WioCellularResult::Ok)
+                    return result;
+                invalidatePdpState();
+
+                return WioCellularResult::Ok;
+            }
+
+            RecoveryAction nextRecoveryAction(void)
+            {
+                if (RecoveryAttempt_ < recovery.reactivatePdpCount)
+                {
+                    if (getNetworkState() == NetworkState::Connected)
+                        return RecoveryAction::ReactivatePdp;
+                    RecoveryAttempt_ = recovery.reactivatePdpCount; // Reactivating is useless without registration
+                }
+                if (RecoveryAttempt_ < recovery.reactivatePdpCount + recovery.restartFunctionalityCount)
+                    return RecoveryAction::RestartFunctionality;
+
+                return RecoveryAction::ResetModem;
+            }
+
+            void executeRecoveryAction(RecoveryAction action)
+            {
+                switch (action)
+                {
+                case RecoveryAction::ReactivatePdp:
+                    printf("---> Recovery: Reactivate PDP context\n");
+                    WioCellular.setPdpContextStatus(config.pdpContextId, 1);
+                    break;
+                case RecoveryAction::RestartFunctionality:
+                    printf("---> Recovery: Restart functionality\n");
+                    if (WioCellular.setPhoneFunctionality(0) == WioCellularResult::Ok)
+                        WioCellular.setPhoneFunctionality(1);
+                    break;
+                case RecoveryAction::ResetModem:
+                    printf("---> Recovery: Reset modem\n");
+                    if (WioCellular.powerOn(recovery.powerOnTimeout) == WioCellularResult::Ok)
+                        enableNotification();
+                    break;
+                default:
+                    break;
+                }
+                invalidatePdpState();
+            }
+
+            static bool isBandInMask(const std::string &mask, int band)
+            {
+                std::string digits;
+                if (!internal::stringStartsWith(mask, "0x", &digits))
+                    return false;
+
+                const size_t index = (band - 1) / 4;
+                if (band < 1 || index >= digits.size())
+                    return false;
+                const auto digit = digits[digits.size() - 1 - index];
+                const int value = isdigit(digit) ? digit - '0' : tolower(digit) - 'a' + 10;
+
+                return (value & 1 << (band - 1) % 4) != 0;
+            }
+
+            static std::string bandToMask(int band)
+            {
+                assert(band >= 1);
+
+                return "0x" + std::string(1, "1248"[(band - 1) % 4]) + std::string((band - 1) / 4, '0');
+            }
+
+            void setSearchFrequencyBandWithRestart(const std::string &ltemBand, const std::string &nbiotBand)
+            {
+                if (WioCellular.setPhoneFunctionality(0) != WioCellularResult::Ok)
+                    return;
+                const auto start = millis();
+                while (getNetworkState() != NetworkState::NotSearching && millis() - start < 5000)
+                {
+                    WioCellular.doWork(10); // Spin
+                }
+                WioCellular.setSearchFrequencyBand("0x0", !ltemBand.empty() ? ltemBand : "0x0", !nbiotBand.empty() ? nbiotBand : "0x0");
+                WioCellular.setPhoneFunctionality(1);
+            }
+
+            void updateBandLearning(void)
+            {
+                if (!loadBandHint || !saveBandHint || BandLearned_)
+                    return;
+
+                if (getNetworkState() == NetworkState::Connected)
+                {
+                    std::string act;
+                    std::string band;
+                    int channel;
+                    if (WioCellular.getNetworkInformation(&act, nullptr, &band, &channel) != WioCellularResult::Ok)
+                        return;
+                    const auto bandPos = band.find_last_of(' ');
+                    BandHint hint{act == "eMTC" ? 0 : act == "NBIoT" ? 1
+                                                                       : -1,
+                                  bandPos != std::string::npos && isdigit(band[bandPos + 1]) ? std::stoi(band.substr(bandPos + 1)) : 0,
+                                  channel};
+                    if (hint.act < 0 || hint.band < 1)
+                        return;
+
+                    BandLearned_ = true;
+                    if (hint.act != BandHint_.act || hint.band != BandHint_.band || hint.channel != BandHint_.channel)
+                    {
+                        printf("---> Band learned (act=%d, band=%d, channel=%d)\n", hint.act, hint.band, hint.channel);
+                        BandHint_ = hint;
+                        saveBandHint(BandHint_);
+                    }
+                    return;
+                }
+
+                if (BandNarrowed_ && millis() - BeginTime_ >= bandLearning.fallbackTimeout)
+                {
+                    printf("---> Band hint failed, fall back to full band\n");
+                    BandNarrowed_ = false;
+                    BandHint_ = {-1, 0, -1};
+                    saveBandHint(BandHint_);
+                    setSearchFrequencyBandWithRestart(config.ltemBand, config.nbiotBand);
+                }
+            }
+
             void defaultAbortHandler(const char *file, int line)
             {
                 Serial.print("ERROR: ");
@@ -193,8 +566,28 @@ namespace wiocellular
              */
             Bg770aNetwork(void)
                 : abortHandler{nullptr},
+                  loadConfigHash{nullptr},
+                  saveConfigHash{nullptr},
+                  loadBandHint{nullptr},
+                  saveBandHint{nullptr},
                   config{SearchAccessTechnology::LTEM_NBIOT, "0x2000000000f0e189f", "0x200000000090f189f", 1, ""},
-                  epsRegistrationStatus{-1}
+                  recovery{false, 1000, 60000, 180000, 2, 2, 20000},
+                  bandLearning{60000},
+                  epsRegistrationStatus{-1},
+                  PdpStateValid_{false},
+                  PdpStateTime_{0},
+                  PdpAddress_{},
+                  RecoveryFailing_{false},
+                  RecoveryFailureTime_{0},
+                  RecoveryNextTime_{0},
+                  RecoveryBackoff_{0},
+                  RecoveryAttempt_{0},
+                  LastRecoveryAction_{RecoveryAction::None},
+                  RecoveryCount_{0},
+                  BandHint_{-1, 0, -1},
+                  BandNarrowed_{false},
+                  BandLearned_{false},
+                  BeginTime_{0}
             {
             }
 
@@ -203,6 +596,8 @@ namespace wiocellular
              * @brief ネットワークを開始
              *
              * ネットワークを初期化します。
+             * loadConfigHashとsaveConfigHashを設定したときは、前回と設定、IMEI、ファームウェアのレビジョンが同じなら、設定の確認を省略します。
+             * loadBandHintとsaveBandHintを設定したときは、前回接続できた周波数バンドに絞ってネットワークを検索します。
              */
             void begin(void)
             {
@@ -214,9 +609,54 @@ namespace wiocellular
                     abortHandler = std::bind(&Bg770aNetwork::defaultAbortHandler, this, std::placeholders::_1, std::placeholders::_2);
                 }
 
+                // Narrow search frequency band to the learned band
+                std::string searchLtemBand = config.ltemBand;
+                std::string searchNbiotBand = config.nbiotBand;
+                BandNarrowed_ = false;
+                BandLearned_ = false;
+                BeginTime_ = millis();
+                if (loadBandHint && saveBandHint)
+                {
+                    if (!loadBandHint(&BandHint_))
+                    {
+                        BandHint_ = {-1, 0, -1};
+                    }
+                    if (BandHint_.act == 0 && isBandInMask(config.ltemBand, BandHint_.band))
+                    {
+                        searchLtemBand = bandToMask(BandHint_.band);
+                        BandNarrowed_ = true;
+                    }
+                    else if (BandHint_.act == 1 && isBandInMask(config.nbiotBand, BandHint_.band))
+                    {
+                        searchNbiotBand = bandToMask(BandHint_.band);
+                        BandNarrowed_ = true;
+                    }
+                }
+
+                // Check cached config hash
+                uint32_t configHash = 0;
+                bool configVerified = false;
+                if (loadConfigHash && saveConfigHash)
+                {
+                    std::string imei;
+                    if ((result = WioCellular.getIMEI(&imei)) != WioCellularResult::Ok)
+                    {
+                        abortHandler(__FILE__, __LINE__);
+                    }
+                    std::string revision;
+                    if ((result = WioCellular.getModemInfo(&revision)) != WioCellularResult::Ok)
+                    {
+                        abortHandler(__FILE__, __LINE__);
+                    }
+                    configHash = calcConfigHash(searchLtemBand, searchNbiotBand, imei, revision);
+
+                    uint32_t savedConfigHash;
+                    configVerified = loadConfigHash(&savedConfigHash) && savedConfigHash == configHash;
+                }
+
                 // Check PDP context
                 bool setPdpContext = false;
-                if (!config.apn.empty())
+                if (!configVerified && !config.apn.empty())
                 {
                     std::vector<WioCellularModule::PdpContext> pdpContexts;
                     if ((result = WioCellular.getPdpContext(&pdpContexts)) != WioCellularResult::Ok)
@@ -232,6 +672,7 @@ namespace wiocellular
 
                 // Check search access technology
                 bool setSearchAccessTechnology = false;
+                if (!configVerified)
                 {
                     int actMode;
                     if ((result = WioCellular.getSearchAccessTechnology(&actMode)) != WioCellularResult::Ok)
@@ -268,7 +709,7 @@ namespace wiocellular
 
                 // Check search frequency band
                 bool setSearchFrequencyBand = false;
-                if (!config.ltemBand.empty() || !config.nbiotBand.empty())
+                if (!configVerified && (!searchLtemBand.empty() || !searchNbiotBand.empty()))
                 {
                     std::string ltemBand;
                     std::string nbiotBand;
@@ -276,31 +717,28 @@ namespace wiocellular
                     {
                         abortHandler(__FILE__, __LINE__);
                     }
-                    if (!config.ltemBand.empty() && ltemBand != config.ltemBand)
+                    if (!searchLtemBand.empty() && ltemBand != searchLtemBand)
                     {
                         setSearchFrequencyBand = true;
                     }
-                    if (!config.nbiotBand.empty() && nbiotBand != config.nbiotBand)
+                    if (!searchNbiotBand.empty() && nbiotBand != searchNbiotBand)
                     {
                         setSearchFrequencyBand = true;
                     }
                 }
 
-                // Register EPS network registration state notification
+                // Register EPS network registration state and PDP context notification
                 WioCellular.registerUrcHandler([this](const std::string &response) -> bool
                                                {
                                                     if (response.compare(0, 8, "+CEREG: ") == 0) {
                                                         wiocellular::module::at_client::AtParameterParser parser{response.substr(8)};
                                                         if (parser.size() < 1) return false;
                                                         epsRegistrationStatus = std::stoi(parser[0]);
+                                                        invalidatePdpState();
                                                         return true;
                                                     }
-                                                    return false; });
-                if ((result = WioCellular.setEpsNetworkRegistrationStatusUrc(1)) != WioCellularResult::Ok)
-                {
-                    abortHandler(__FILE__, __LINE__);
-                }
-                if ((result = WioCellular.getEpsNetworkRegistrationState(&epsRegistrationStatus)) != WioCellularResult::Ok)
+                                                    return processPdpUrc(response); });
+                if ((result = enableNotification()) != WioCellularResult::Ok)
                 {
                     abortHandler(__FILE__, __LINE__);
                 }
@@ -373,7 +811,7 @@ namespace wiocellular
                     // Set search frequency band
                     if (setSearchFrequencyBand)
                     {
-                        if ((result = WioCellular.setSearchFrequencyBand("0x0", !config.ltemBand.empty() ? config.ltemBand : "0x0", !config.nbiotBand.empty() ? config.nbiotBand : "0x0")) != WioCellularResult::Ok)
+                        if ((result = WioCellular.setSearchFrequencyBand("0x0", !searchLtemBand.empty() ? searchLtemBand : "0x0", !searchNbiotBand.empty() ? searchNbiotBand : "0x0")) != WioCellularResult::Ok)
                         {
                             abortHandler(__FILE__, __LINE__);
                         }
@@ -388,6 +826,12 @@ namespace wiocellular
                         }
                     }
                 }
+
+                // Save config hash
+                if (!configVerified && loadConfigHash && saveConfigHash)
+                {
+                    saveConfigHash(configHash);
+                }
             }
 
             /**
@@ -437,32 +881,150 @@ namespace wiocellular
              * @~Japanese
              * @brief 通信可否を取得
              *
+             * @param [in] forceRefresh PDPコンテキストを読み直す。
              * @retval true 通信可能
              * @retval false 通信不可能
              *
              * 通信可否を取得します。
+             * PDPコンテキストの状態はURC(+CEREG、+CGEV、+QIURC: "pdpdeact")で更新するので、通常はATコマンドを送信しません。
+             * 状態が変化したときと、forceRefreshがtrueのときだけPDPコンテキストを読み込みます。
+             * 通信不可能な状態は、通知を取りこぼしたときのためにPDP_INACTIVE_RECHECK_INTERVAL毎に読み直します。
+             * recovery.enableがtrueのときは、読み込みに失敗しても異常終了せずに通信不可能を返します。
              */
-            bool canCommunicate(void)
+            bool canCommunicate(bool forceRefresh = false)
             {
                 if (getNetworkState() != Bg770aNetwork::NetworkState::Connected)
                     return false;
 
+                if (PdpStateValid_ && !forceRefresh && (!PdpAddress_.empty() || millis() - PdpStateTime_ < PDP_INACTIVE_RECHECK_INTERVAL))
+                    return !PdpAddress_.empty();
+
                 WioCellularResult result;
 
                 // Get PDP contexts
                 std::vector<WioCellularModule::PdpContext> pdpContexts;
                 if ((result = WioCellular.getPdpContext(&pdpContexts)) != WioCellularResult::Ok)
                 {
-                    abortHandler(__FILE__, __LINE__);
+                    if (!recovery.enable)
+                    {
+                        abortHandler(__FILE__, __LINE__);
+                    }
+                    setPdpDeactivated(); // Let supervise() recover the module
+                    return false;
                 }
 
                 // Get specific PDP context
                 const auto pdpContext = std::find_if(pdpContexts.begin(), pdpContexts.end(), [this](const WioCellularModule::PdpContext &pdpContext)
                                                      { return pdpContext.cid == config.pdpContextId; });
-                if (pdpContext == pdpContexts.end())
-                    return false;
+                if (pdpContext == pdpContexts.end() || pdpContext->pdpAddr == "0.0.0.0")
+                {
+                    setPdpDeactivated();
+                }
+                else
+                {
+                    PdpStateValid_ = true;
+                    PdpStateTime_ = millis();
+                    PdpAddress_ = pdpContext->pdpAddr;
+                }
+
+                return !PdpAddress_.empty();
+            }
+
+            /**
+             * @~Japanese
+             * @brief PDPアドレスを取得
+             *
+             * @return PDPアドレス。通信不可能なときは空。
+             *
+             * canCommunicate()で読み込んだPDPアドレスを取得します。ATコマンドは送信しません。
+             */
+            const std::string &getPdpAddress(void) const
+            {
+                return PdpAddress_;
+            }
 
-                return pdpContext->pdpAddr != "0.0.0.0";
+            /**
+             * @~Japanese
+             * @brief 通信を監視して復旧
+             *
+             * 通信できなくなったとき(登録解除、PDPコンテキストの非活性化、ソケットの切断通知など)に、段階的に復旧の処理をします。
+             * 1. PDPコンテキストを活性化(recovery.reactivatePdpCount回)
+             * 2. 機能を停止して再開(recovery.restartFunctionalityCount回)
+             * 3. モジュールをリセット
+             *
+             * 処理の間隔はrecovery.initialBackoffから2倍ずつ、recovery.maxBackoffまで延ばします。
+             * ネットワーク検索中は、recovery.searchTimeoutが経過するまで待ちます。
+             * 通信できるようになると、最初の段階に戻ります。
+             * モジュールをリセットすると、begin()以外で行ったモジュールの設定(PSMなど)は失われます。
+             *
+             * loadBandHintとsaveBandHintを設定したときは、接続できた周波数バンドを保存します。
+             * 絞った周波数バンドでbandLearning.fallbackTimeoutまでに接続できないときは、元の周波数バンドに戻します。
+             *
+             * recovery.enableがfalseのときは、周波数バンドの学習だけを行います。
+             * loop()から定期的に呼び出してください。
+             */
+            void supervise(void)
+            {
+                updateBandLearning();
+
+                if (!recovery.enable)
+                    return;
+
+                WioCellular.doWork(0); // Process pending URCs
+
+                const auto now = millis();
+                if (canCommunicate())
+                {
+                    RecoveryFailing_ = false;
+                    return;
+                }
+
+                if (!RecoveryFailing_)
+                {
+                    RecoveryFailing_ = true;
+                    RecoveryFailureTime_ = now;
+                    RecoveryNextTime_ = now;
+                    RecoveryBackoff_ = recovery.initialBackoff;
+                    RecoveryAttempt_ = 0;
+                }
+
+                if (getNetworkState() == NetworkState::Searching && now - RecoveryFailureTime_ < recovery.searchTimeout)
+                    return;
+                if (static_cast<int32_t>(now - RecoveryNextTime_) < 0)
+                    return;
+
+                const auto action = nextRecoveryAction();
+                executeRecoveryAction(action);
+                LastRecoveryAction_ = action;
+                ++RecoveryCount_;
+                ++RecoveryAttempt_;
+
+                RecoveryNextTime_ = millis() + RecoveryBackoff_;
+                RecoveryBackoff_ = RecoveryBackoff_ < recovery.maxBackoff / 2 ? RecoveryBackoff_ * 2 : recovery.maxBackoff;
+                if (action != RecoveryAction::ReactivatePdp)
+                    RecoveryFailureTime_ = millis(); // Wait for network search again
+            }
+
+            /**
+             * @~Japanese
+             * @brief 最後の復旧の処理を取得
+             *
+             * @return 最後の復旧の処理。
+             */
+            RecoveryAction getLastRecoveryAction(void) const
+            {
+                return LastRecoveryAction_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 復旧の処理をした回数を取得
+             *
+             * @return 復旧の処理をした回数。
+             */
+            int getRecoveryCount(void) const
+            {
+                return RecoveryCount_;
             }
         };
 
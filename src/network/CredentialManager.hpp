@@ -0,0 +1,177 @@
+/*
+ * CredentialManager.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef CREDENTIALMANAGER_HPP
+#define CREDENTIALMANAGER_HPP
+
+#include <string>
+#include <vector>
+#include "internal/Crc32.hpp"
+#include "internal/Misc.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] 証明書ファイルの管理クラス
+         *
+         * @tparam MODULE モジュールのクラス
+         *
+         * 証明書などをモジュールのファイルシステムへ配置するクラスです。
+         * ファイル名に内容のハッシュ(CRC-32)を含めるので、AT+QFLSTの1回の問い合わせで、配置済みのファイルと内容が同じかを判定できます。
+         * 内容が異なるときだけアップロードするので、起動の度に証明書をアップロードする時間を省略できます。
+         */
+        template <typename MODULE>
+        class CredentialManager
+        {
+        private:
+            MODULE &Module_;
+
+        private:
+            static void splitName(const std::string &name, std::string *stem, std::string *extension)
+            {
+                const auto dot = name.find_last_of('.');
+                *stem = name.substr(0, dot);
+                *extension = dot != std::string::npos ? name.substr(dot) : "";
+            }
+
+            // <stem>_<8 lowercase hex digits><extension>, as named by install()
+            static bool isHashedName(const std::string &name, const std::string &stem, const std::string &extension)
+            {
+                constexpr size_t HASH_LENGTH = 8;
+
+                if (name.size() != stem.size() + 1 + HASH_LENGTH + extension.size())
+                    return false;
+                if (name.compare(0, stem.size(), stem) != 0 || name[stem.size()] != '_')
+                    return false;
+                if (name.compare(stem.size() + 1 + HASH_LENGTH, extension.size(), extension) != 0)
+                    return false;
+                for (size_t i = stem.size() + 1; i < stem.size() + 1 + HASH_LENGTH; ++i)
+                {
+                    if (!(('0' <= name[i] && name[i] <= '9') || ('a' <= name[i] && name[i] <= 'f')))
+                        return false;
+                }
+
+                return true;
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             *
+             * コンストラクタ。
+             */
+            explicit CredentialManager(MODULE &module) : Module_{module}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief ファイルを配置
+             *
+             * @param [in] name ファイル名。例: "cacert.pem"
+             * @param [in] data ファイルの内容。
+             * @param [in] dataSize ファイルのサイズ。
+             * @param [out] path 配置したファイルのパス。nullptrを指定すると値を代入しません。例: "cacert_1a2b3c4d.pem"
+             * @return 実行結果。
+             *
+             * ファイル名にハッシュを付けたファイルを、モジュールのファイルシステムへ配置します。
+             * 同じハッシュとサイズのファイルが既にあるときはアップロードしません。
+             * 内容が異なる古いファイルは削除します。
+             */
+            WioCellularResult install(const std::string &name, const void *data, size_t dataSize, std::string *path)
+            {
+                assert(!name.empty());
+                assert(data);
+                assert(dataSize >= 1);
+
+                if (path)
+                    path->clear();
+
+                std::string stem;
+                std::string extension;
+                splitName(name, &stem, &extension);
+                const auto hashedName = internal::stringFormat("%s_%08lx%s", stem.c_str(), static_cast<unsigned long>(internal::crc32(data, dataSize)), extension.c_str());
+
+                WioCellularResult result;
+
+                std::vector<typename MODULE::FileInfo> files;
+                if ((result = Module_.listFiles(stem + "_*", &files)) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+
+                bool installed = false;
+                for (const auto &file : files)
+                {
+                    if (file.name == hashedName && file.size == dataSize)
+                    {
+                        installed = true;
+                        continue;
+                    }
+                    if (isHashedName(file.name, stem, extension))
+                    {
+                        if ((result = Module_.deleteFile(file.name)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                    }
+                }
+
+                if (!installed)
+                {
+                    if ((result = Module_.uploadFile(hashedName, data, dataSize)) != WioCellularResult::Ok)
+                    {
+                        return result;
+                    }
+                }
+
+                if (path)
+                    *path = hashedName;
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief SSLの証明書ファイルを配置して設定
+             *
+             * @param [in] sslContextId SSLコンテキストID。
+             * @param [in] type 証明書の種類。
+             *   @arg "cacert": 信頼するCA証明書
+             *   @arg "clientcert": クライアント証明書
+             *   @arg "clientkey": クライアントの秘密鍵
+             * @param [in] data 証明書の内容(PEM)。
+             * @param [in] dataSize 証明書のサイズ。
+             * @return 実行結果。
+             *
+             * install()で証明書ファイルを配置して、SSLコンテキストに設定します。
+             */
+            WioCellularResult installSslCertificate(int sslContextId, const std::string &type, const void *data, size_t dataSize)
+            {
+                WioCellularResult result;
+
+                std::string path;
+                if ((result = install(type + ".pem", data, dataSize, &path)) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+
+                return Module_.setSslCertificate(sslContextId, type, path);
+            }
+        };
+
+    }
+}
+
+#endif // CREDENTIALMANAGER_HPP
@@ -0,0 +1,325 @@
+/*
+ * DnsResolver.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef DNSRESOLVER_HPP
+#define DNSRESOLVER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] TTL付きキャッシュを持つ名前解決クラス
+         *
+         * @tparam MODULE モジュールのクラス
+         * @tparam N キャッシュするホスト名の数
+         *
+         * AT+QIDNSGIPで解決したIPアドレスをTTLの間キャッシュします。
+         * openSocket()はキャッシュしたIPアドレスを使ってソケットをオープンするので、オープン時のDNS問い合わせを省略できます。
+         * save()とload()で、キャッシュをFeRAMなどへ保存、復元できます。
+         */
+        template <typename MODULE, size_t N = 4>
+        class DnsResolver
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief ホスト名の最大長
+             */
+            static constexpr size_t HOST_NAME_SIZE_MAX = 63;
+            /**
+             * @~Japanese
+             * @brief IPアドレスの最大長
+             */
+            static constexpr size_t IP_ADDRESS_SIZE_MAX = 39;
+
+        private:
+            static constexpr uint32_t PERSIST_MAGIC = 0x534e4457; // "WDNS"
+
+            struct Entry
+            {
+                char hostName[HOST_NAME_SIZE_MAX + 1];
+                char ipAddress[IP_ADDRESS_SIZE_MAX + 1];
+                uint32_t expire; // [ms] millis() based, or remaining time when persisted
+            };
+
+            struct Persist
+            {
+                uint32_t magic;
+                std::array<Entry, N> entries;
+            };
+
+        private:
+            MODULE &Module_;
+            int PdpContextId_;
+            std::array<Entry, N> Entries_;
+
+        public:
+            /**
+             * @~Japanese
+             * @brief 保存に必要なサイズ
+             */
+            static constexpr size_t PERSIST_SIZE = sizeof(Persist);
+
+            /**
+             * @~Japanese
+             * @brief キャッシュするTTLの下限[秒]
+             *
+             * DNSサーバーが返したTTLがこの値より短いときは、この値を使います。
+             */
+            uint32_t minimumTtl;
+
+        private:
+            static bool isIpAddress(const std::string &hostName)
+            {
+                if (hostName.find(':') != std::string::npos)
+                    return true; // IPv6
+
+                for (const auto c : hostName)
+                {
+                    if (!('0' <= c && c <= '9') && c != '.')
+                        return false;
+                }
+                return true;
+            }
+
+            static bool isExpired(const Entry &entry, uint32_t now)
+            {
+                return static_cast<int32_t>(entry.expire - now) <= 0;
+            }
+
+            Entry *find(const std::string &hostName)
+            {
+                for (auto &entry : Entries_)
+                {
+                    if (entry.hostName[0] != '\0' && hostName == entry.hostName)
+                        return &entry;
+                }
+                return nullptr;
+            }
+
+            Entry &findVictim(uint32_t now)
+            {
+                Entry *victim = &Entries_[0];
+                for (auto &entry : Entries_)
+                {
+                    if (entry.hostName[0] == '\0' || isExpired(entry, now))
+                        return entry;
+                    if (static_cast<int32_t>(entry.expire - victim->expire) < 0)
+                        victim = &entry;
+                }
+                return *victim;
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             * @param [in] pdpContextId PDPコンテキストID。
+             *
+             * コンストラクタ。
+             */
+            DnsResolver(MODULE &module, int pdpContextId) : Module_{module},
+                                                            PdpContextId_{pdpContextId},
+                                                            Entries_{},
+                                                            minimumTtl{60}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief 名前解決
+             *
+             * @param [in] hostName ホスト名。
+             * @param [out] ipAddress IPアドレス。nullptrを指定すると値を代入しません。
+             * @return 実行結果。
+             *
+             * ホスト名からIPアドレスを取得します。
+             * hostNameがIPアドレスのときはそのまま返します。
+             * キャッシュが有効なときはモジュールに問い合わせません。
+             */
+            WioCellularResult resolve(const std::string &hostName, std::string *ipAddress)
+            {
+                if (ipAddress)
+                    ipAddress->clear();
+
+                if (isIpAddress(hostName))
+                {
+                    if (ipAddress)
+                        *ipAddress = hostName;
+                    return WioCellularResult::Ok;
+                }
+
+                const auto now = millis();
+                const auto entry = find(hostName);
+                if (entry && !isExpired(*entry, now))
+                {
+                    if (ipAddress)
+                        *ipAddress = entry->ipAddress;
+                    return WioCellularResult::Ok;
+                }
+
+                WioCellularResult result;
+                std::vector<std::string> ipAddresses;
+                int ttl;
+                if ((result = Module_.getIpAddressByHostName(PdpContextId_, hostName, &ipAddresses, &ttl)) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+                if (ipAddresses.empty())
+                {
+                    return WioCellularResult::DnsError;
+                }
+
+                if (hostName.size() <= HOST_NAME_SIZE_MAX && ipAddresses[0].size() <= IP_ADDRESS_SIZE_MAX)
+                {
+                    auto &newEntry = entry ? *entry : findVictim(now);
+                    strcpy(newEntry.hostName, hostName.c_str());
+                    strcpy(newEntry.ipAddress, ipAddresses[0].c_str());
+                    newEntry.expire = now + std::max(static_cast<uint32_t>(ttl > 0 ? ttl : 0), minimumTtl) * 1000;
+                }
+
+                if (ipAddress)
+                    *ipAddress = ipAddresses[0];
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief ソケットをオープン
+             *
+             * @param [in] connectId 接続ID。
+             * @param [in] serviceType サービスタイプ。
+             * @param [in] hostName ホスト名もしくはIPアドレス。
+             * @param [in] remotePort リモートポート番号。
+             * @param [in] localPort ローカルポート番号。
+             * @return 実行結果。
+             *
+             * resolve()で得たIPアドレスを使ってソケットをオープンします。
+             * キャッシュしたIPアドレスでオープンに失敗したときは、キャッシュを破棄してホスト名でオープンし直します。
+             */
+            WioCellularResult openSocket(int connectId, const std::string &serviceType, const std::string &hostName, int remotePort, int localPort)
+            {
+                std::string ipAddress;
+                if (resolve(hostName, &ipAddress) != WioCellularResult::Ok)
+                {
+                    return Module_.openSocket(PdpContextId_, connectId, serviceType, hostName, remotePort, localPort);
+                }
+
+                const auto result = Module_.openSocket(PdpContextId_, connectId, serviceType, ipAddress, remotePort, localPort);
+                if (result != WioCellularResult::OpenError || ipAddress == hostName)
+                {
+                    return result;
+                }
+
+                invalidate(hostName);
+                return Module_.openSocket(PdpContextId_, connectId, serviceType, hostName, remotePort, localPort);
+            }
+
+            /**
+             * @~Japanese
+             * @brief キャッシュを破棄
+             *
+             * @param [in] hostName ホスト名。
+             *
+             * 指定したホスト名のキャッシュを破棄します。
+             */
+            void invalidate(const std::string &hostName)
+            {
+                const auto entry = find(hostName);
+                if (entry)
+                    *entry = {};
+            }
+
+            /**
+             * @~Japanese
+             * @brief 全てのキャッシュを破棄
+             *
+             * 全てのキャッシュを破棄します。
+             */
+            void clear(void)
+            {
+                Entries_.fill({});
+            }
+
+            /**
+             * @~Japanese
+             * @brief キャッシュを保存
+             *
+             * @param [out] data 保存先。PERSIST_SIZEバイト必要です。
+             *
+             * キャッシュをdataへ書き出します。
+             * dataをFeRAMなどへ書き込むと、リセット後もload()でキャッシュを復元できます。
+             * 有効期限は残り時間で保存するので、電源オフの期間は期限に含まれません。
+             */
+            void save(void *data) const
+            {
+                assert(data);
+
+                const auto now = millis();
+                Persist persist{PERSIST_MAGIC, Entries_};
+                for (auto &entry : persist.entries)
+                {
+                    entry.expire = entry.hostName[0] == '\0' || isExpired(entry, now) ? 0 : entry.expire - now;
+                }
+                memcpy(data, &persist, sizeof(persist));
+            }
+
+            /**
+             * @~Japanese
+             * @brief キャッシュを復元
+             *
+             * @param [in] data save()で保存したデータ。PERSIST_SIZEバイト必要です。
+             * @retval true 成功
+             * @retval false データが不正
+             *
+             * save()で保存したキャッシュを復元します。
+             */
+            bool load(const void *data)
+            {
+                assert(data);
+
+                Persist persist;
+                memcpy(&persist, data, sizeof(persist));
+                if (persist.magic != PERSIST_MAGIC)
+                    return false;
+
+                const auto now = millis();
+                for (size_t i = 0; i < N; ++i)
+                {
+                    auto &entry = persist.entries[i];
+                    entry.hostName[HOST_NAME_SIZE_MAX] = '\0';
+                    entry.ipAddress[IP_ADDRESS_SIZE_MAX] = '\0';
+                    if (entry.hostName[0] == '\0' || entry.expire == 0)
+                    {
+                        Entries_[i] = {};
+                        continue;
+                    }
+                    entry.expire += now;
+                    Entries_[i] = entry;
+                }
+
+                return true;
+            }
+        };
+
+    }
+}
+
+#endif // DNSRESOLVER_HPP
@@ -0,0 +1,557 @@
+/*
+ * PsmScheduler.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef PSMSCHEDULER_HPP
+#define PSMSCHEDULER_HPP
+
+#include <functional>
+#include <string>
+#include "WioCellularResult.hpp"
+#include "internal/RingBuffer.hpp"
+#include "internal/Misc.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] PSMに合わせて送信するクラス
+         *
+         * @tparam MODULE モジュールのクラス
+         * @tparam JOB_COUNT 溜めておく送信の最大数
+         *
+         * 送信を溜めておき、モジュールが起きている時間(アクティブ時間)に合わせてまとめて実行するクラスです。
+         * ネットワークが割り当てたPSMのタイマー(T3324、T3412)とeDRXをAT+CEREG(モード4)とAT+CEDRXRDPで取得し、
+         * PSMへの遷移をURC(+QPSMTIMER)で検出します。
+         *
+         * 送信はアクティブ時間が残っているとき、モジュールが周期更新(TAU)で自ら起きたとき、もしくは期限の直前に実行します。
+         * 期限の直前に起こすときは、スリープ中であればDTRで、PSM中であればPWRKEYで起こします。
+         * 送信した後はDTRでスリープを許可します。
+         *
+         * 事前にsetPsm()でPSMを有効にしてください。process()はloop()から定期的に呼び出してください。
+         */
+        template <typename MODULE, size_t JOB_COUNT = 8>
+        class PsmScheduler
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief 送信する関数の型
+             */
+            using JobType = std::function<WioCellularResult(void)>;
+
+            /**
+             * @~Japanese
+             * @brief スケジュールの設定
+             */
+            struct
+            {
+                /**
+                 * @~Japanese
+                 * @brief 期限より前に起こす時間[ミリ秒]
+                 *
+                 * モジュールの起動と接続にかかる時間です。
+                 */
+                uint32_t wakeupLeadTime;
+                /**
+                 * @~Japanese
+                 * @brief アクティブ時間の終わりに確保する余裕[ミリ秒]
+                 *
+                 * アクティブ時間の残りがこの値より短いときは、送信せずにPSMへの遷移を待ちます。
+                 */
+                uint32_t activeTimeGuard;
+                /**
+                 * @~Japanese
+                 * @brief PWRKEYで起こすときのタイムアウト時間[ミリ秒]
+                 */
+                int powerOnTimeout;
+                /**
+                 * @~Japanese
+                 * @brief 送信した後にDTRでスリープを許可するか
+                 */
+                bool sleepAfterTransmit;
+                /**
+                 * @~Japanese
+                 * @brief 失敗したときに再実行するまでの最初の待ち時間[ミリ秒]
+                 *
+                 * 続けて失敗する度に2倍にします。
+                 */
+                uint32_t initialRetryBackoff;
+                /**
+                 * @~Japanese
+                 * @brief 失敗したときに再実行するまでの最大の待ち時間[ミリ秒]
+                 */
+                uint32_t maxRetryBackoff;
+            } config;
+
+        private:
+            struct Job
+            {
+                JobType send;
+                uint32_t deadline;
+            };
+
+            using UrcHandlerIterator = decltype(std::declval<MODULE &>().registerUrcHandler(nullptr));
+
+            MODULE &Module_;
+            bool UrcHandlerRegistered_;
+            UrcHandlerIterator UrcHandler_;
+
+            internal::RingBuffer<Job, JOB_COUNT> Jobs_;
+            uint32_t EarliestDeadline_;
+
+            int ActiveTime_;
+            int PeriodicTau_;
+            int EdrxActType_;
+            int EdrxCycle_;
+            int PagingTimeWindow_;
+
+            bool InPsm_;
+            bool PoweredDown_;
+            uint32_t PsmEnteredTime_;
+            uint32_t LastActivityTime_;
+            size_t PsmEnteredCount_;
+            size_t WakeupCount_;
+
+            uint32_t RetryBackoff_;
+            bool RetryPending_;
+            uint32_t RetryTime_;
+
+            bool handleUrc(const std::string &response)
+            {
+                // +QPSMTIMER: <tau_timer>,<T3324_timer>
+                if (internal::stringStartsWith(response, "+QPSMTIMER: "))
+                {
+                    enterPsm();
+                    return true;
+                }
+                if (response == "ENTER PSM")
+                {
+                    enterPsm();
+                    return true;
+                }
+
+                return false;
+            }
+
+            void enterPsm(void)
+            {
+                if (InPsm_)
+                    return;
+
+                InPsm_ = true;
+                PoweredDown_ = false;
+                PsmEnteredTime_ = millis();
+                ++PsmEnteredCount_;
+                if (psmEnteredHandler)
+                    psmEnteredHandler();
+            }
+
+            bool isActiveTimeRemaining(uint32_t now) const
+            {
+                if (InPsm_)
+                    return false;
+                if (ActiveTime_ < 0)
+                    return true;
+
+                return now - LastActivityTime_ + config.activeTimeGuard < static_cast<uint32_t>(ActiveTime_) * 1000;
+            }
+
+            WioCellularResult wakeup(void)
+            {
+                if (!Module_.getInterface().isActive())
+                {
+                    WioCellularResult result;
+                    if ((result = Module_.powerOn(config.powerOnTimeout)) != WioCellularResult::Ok)
+                        return result;
+                }
+                Module_.getInterface().wakeup();
+
+                return WioCellularResult::Ok;
+            }
+
+            void updatePowerState(uint32_t now)
+            {
+                if (!InPsm_)
+                    return;
+
+                // +QPSMTIMER arrives before the module powers down, so only a power-down followed by a power-up is a wakeup.
+                if (!Module_.getInterface().isActive())
+                {
+                    PoweredDown_ = true;
+                }
+                else if (PoweredDown_)
+                {
+                    InPsm_ = false; // Woken up by the periodic TAU
+                    PoweredDown_ = false;
+                    LastActivityTime_ = now;
+                }
+            }
+
+            void scheduleRetry(uint32_t now)
+            {
+                if (!RetryPending_)
+                    RetryBackoff_ = config.initialRetryBackoff;
+                else
+                    RetryBackoff_ = RetryBackoff_ < config.maxRetryBackoff / 2 ? RetryBackoff_ * 2 : config.maxRetryBackoff;
+                RetryPending_ = true;
+                RetryTime_ = now + RetryBackoff_;
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief PSMへ遷移したときに呼び出す関数
+             *
+             * URC(+QPSMTIMER)を受信したときに呼び出します。
+             */
+            std::function<void(void)> psmEnteredHandler;
+
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             *
+             * コンストラクタ。
+             */
+            explicit PsmScheduler(MODULE &module)
+                : config{5000, 2000, 20000, true, 5000, 300000},
+                  Module_{module},
+                  UrcHandlerRegistered_{false},
+                  UrcHandler_{},
+                  Jobs_{},
+                  EarliestDeadline_{0},
+                  ActiveTime_{-1},
+                  PeriodicTau_{-1},
+                  EdrxActType_{0},
+                  EdrxCycle_{-1},
+                  PagingTimeWindow_{-1},
+                  InPsm_{false},
+                  PoweredDown_{false},
+                  PsmEnteredTime_{0},
+                  LastActivityTime_{0},
+                  PsmEnteredCount_{0},
+                  WakeupCount_{0},
+                  RetryBackoff_{0},
+                  RetryPending_{false},
+                  RetryTime_{0},
+                  psmEnteredHandler{}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief デストラクタ
+             *
+             * デストラクタ。
+             */
+            ~PsmScheduler(void)
+            {
+                if (UrcHandlerRegistered_)
+                    Module_.unregisterUrcHandler(UrcHandler_);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 開始
+             *
+             * @return 実行結果。
+             *
+             * PSM遷移のURC通知を有効にして、ネットワークが割り当てたタイマーを取得します。
+             * ネットワークに登録した後に呼び出してください。
+             */
+            WioCellularResult begin(void)
+            {
+                if (!UrcHandlerRegistered_)
+                {
+                    UrcHandler_ = Module_.registerUrcHandler([this](const std::string &response) -> bool
+                                                             { return handleUrc(response); });
+                    UrcHandlerRegistered_ = true;
+                }
+
+                WioCellularResult result;
+
+                if ((result = Module_.setPsmEnteringIndicationUrc(true)) != WioCellularResult::Ok)
+                    return result;
+
+                InPsm_ = false;
+                PoweredDown_ = false;
+                LastActivityTime_ = millis();
+
+                return refresh();
+            }
+
+            /**
+             * @~Japanese
+             * @brief タイマーを取得し直す
+             *
+             * @return 実行結果。
+             *
+             * ネットワークが割り当てたPSMのタイマーとeDRXを取得し直します。
+             * AT+CEREGをモード4にするので、+CEREGのURCにタイマーが付くようになります。
+             * モジュールが起きているときに呼び出してください。
+             */
+            WioCellularResult refresh(void)
+            {
+                WioCellularResult result;
+
+                if ((result = Module_.setEpsNetworkRegistrationStatusUrc(4)) != WioCellularResult::Ok)
+                    return result;
+                if ((result = Module_.getEpsNetworkRegistrationPsmTimers(&ActiveTime_, &PeriodicTau_)) != WioCellularResult::Ok)
+                    return result;
+                if ((result = Module_.getEdrxDynamicParameters(&EdrxActType_, &EdrxCycle_, &PagingTimeWindow_)) != WioCellularResult::Ok)
+                    return result;
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信を追加
+             *
+             * @param [in] send 送信する関数。Okを返すと完了、それ以外を返すと次の機会に再実行します。
+             * @param [in] maxDelay 送信を遅らせる最大時間[ミリ秒]。
+             * @retval true 追加した
+             * @retval false 溜めておく最大数を超えた
+             *
+             * 送信を溜めます。溜めた送信は、process()でまとめて実行します。
+             */
+            bool schedule(const JobType &send, uint32_t maxDelay)
+            {
+                assert(send);
+
+                size_t regionSize;
+                auto region = Jobs_.writableRegion(&regionSize);
+                if (regionSize == 0)
+                    return false;
+
+                const uint32_t deadline = millis() + maxDelay;
+                if (Jobs_.empty() || static_cast<int32_t>(deadline - EarliestDeadline_) < 0)
+                    EarliestDeadline_ = deadline;
+                *region = {send, deadline};
+                Jobs_.commit(1);
+
+                return true;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 条件を満たしていれば送信
+             *
+             * @return 実行結果。
+             *
+             * 次のいずれかを満たすときに、溜めている送信を全て実行します。
+             * - アクティブ時間が残っている
+             * - PSM中のモジュールが周期更新(TAU)で起きた
+             * - 最も早い期限の、config.wakeupLeadTime前になった
+             *
+             * 失敗した後は、config.initialRetryBackoffから倍々に延ばした待ち時間が経過するまで実行しません。
+             * loop()から定期的に呼び出してください。
+             */
+            WioCellularResult process(void)
+            {
+                Module_.doWork(0); // Process pending URCs
+
+                const uint32_t now = millis();
+                updatePowerState(now);
+
+                if (Jobs_.empty())
+                    return WioCellularResult::Ok;
+                if (RetryPending_ && static_cast<int32_t>(now - RetryTime_) < 0)
+                    return WioCellularResult::Ok;
+
+                if (isActiveTimeRemaining(now) ||
+                    static_cast<int32_t>(now + config.wakeupLeadTime - EarliestDeadline_) >= 0)
+                {
+                    return flush();
+                }
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信
+             *
+             * @return 実行結果。
+             *
+             * モジュールを起こして、溜めている送信を全て実行します。
+             * 失敗したときは、失敗した送信以降を残して、process()での再実行を待たせます。
+             */
+            WioCellularResult flush(void)
+            {
+                if (Jobs_.empty())
+                    return WioCellularResult::Ok;
+
+                WioCellularResult result;
+
+                if (!isActiveTimeRemaining(millis()))
+                    ++WakeupCount_;
+                if ((result = wakeup()) != WioCellularResult::Ok)
+                {
+                    scheduleRetry(millis());
+                    return result;
+                }
+                InPsm_ = false;
+                PoweredDown_ = false;
+
+                while (!Jobs_.empty())
+                {
+                    if ((result = Jobs_.front().send()) != WioCellularResult::Ok)
+                        break;
+                    Jobs_.pop();
+                }
+
+                if (result == WioCellularResult::Ok)
+                {
+                    LastActivityTime_ = millis();
+                    RetryPending_ = false;
+                }
+                else
+                {
+                    scheduleRetry(millis());
+                }
+
+                if (!Jobs_.empty())
+                {
+                    // Retry the remaining jobs at the earliest deadline
+                    EarliestDeadline_ = Jobs_.front().deadline;
+                    for (size_t i = Jobs_.size(); i >= 1; --i)
+                    {
+                        Job job = Jobs_.front();
+                        Jobs_.pop();
+                        if (static_cast<int32_t>(job.deadline - EarliestDeadline_) < 0)
+                            EarliestDeadline_ = job.deadline;
+                        size_t regionSize;
+                        *Jobs_.writableRegion(&regionSize) = std::move(job);
+                        Jobs_.commit(1);
+                    }
+                }
+
+                if (config.sleepAfterTransmit)
+                    Module_.getInterface().sleep();
+
+                return result;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 次に起きる時刻を取得
+             *
+             * @param [out] time 時刻。millis()の値。
+             * @retval true 取得した
+             * @retval false PSM中でないか、周期時間が分からない
+             *
+             * PSM中のモジュールが周期更新(TAU)で次に起きる時刻を予測します。
+             */
+            bool getNextWakeupTime(uint32_t *time) const
+            {
+                assert(time);
+
+                if (!InPsm_ || PeriodicTau_ < 0)
+                    return false;
+
+                const auto activeTime = ActiveTime_ >= 0 ? ActiveTime_ : 0;
+                *time = PsmEnteredTime_ + static_cast<uint32_t>(PeriodicTau_ - activeTime) * 1000;
+
+                return true;
+            }
+
+            /**
+             * @~Japanese
+             * @brief PSM中かを取得
+             *
+             * @retval true PSM中
+             * @retval false PSM中でない
+             */
+            bool isInPsm(void) const
+            {
+                return InPsm_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief アクティブ時間(T3324)を取得
+             *
+             * @return アクティブ時間[秒]。割り当てられていないときは-1。
+             */
+            int getActiveTime(void) const
+            {
+                return ActiveTime_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 周期時間(T3412)を取得
+             *
+             * @return 周期時間[秒]。割り当てられていないときは-1。
+             */
+            int getPeriodicTau(void) const
+            {
+                return PeriodicTau_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief eDRXを取得
+             *
+             * @param [out] actType アクセステクノロジータイプ。getEdrxDynamicParameters()と同じ値。nullptrを指定すると値を代入しません。
+             * @param [out] edrxCycle eDRX周期。setEdrx()のedrxCycleと同じ値。nullptrを指定すると値を代入しません。
+             * @param [out] pagingTimeWindow ページング時間窓。nullptrを指定すると値を代入しません。
+             */
+            void getEdrx(int *actType, int *edrxCycle, int *pagingTimeWindow) const
+            {
+                if (actType)
+                    *actType = EdrxActType_;
+                if (edrxCycle)
+                    *edrxCycle = EdrxCycle_;
+                if (pagingTimeWindow)
+                    *pagingTimeWindow = PagingTimeWindow_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 溜めている送信の数を取得
+             *
+             * @return 溜めている送信の数。
+             */
+            size_t size(void) const
+            {
+                return Jobs_.size();
+            }
+
+            /**
+             * @~Japanese
+             * @brief PSMへ遷移した回数を取得
+             *
+             * @return PSMへ遷移した回数。
+             */
+            size_t getPsmEnteredCount(void) const
+            {
+                return PsmEnteredCount_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief アクティブ時間の外で起こした回数を取得
+             *
+             * @return アクティブ時間の外で起こした回数。
+             *
+             * 周期更新(TAU)に合わせられず、送信のために起こした回数です。
+             */
+            size_t getWakeupCount(void) const
+            {
+                return WakeupCount_;
+            }
+        };
+
+    }
+}
+
+#endif // PSMSCHEDULER_HPP
@@ -0,0 +1,479 @@
+/*
+ * ResumableDownloader.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef RESUMABLEDOWNLOADER_HPP
+#define RESUMABLEDOWNLOADER_HPP
+
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <strings.h>
+#include "internal/Crc32.hpp"
+#include "internal/Misc.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] 中断しても続きから再開できるダウンローダー
+         *
+         * @tparam MODULE モジュールのクラス
+         * @tparam STORAGE 保存先のクラス。readBuffer(address, buffer, size)とwriteBuffer(address, buffer, size)を持つクラス。例: Adafruit_SPIFlash
+         * @tparam CHUNK_SIZE 受信の単位[バイト]
+         *
+         * HTTPでダウンロードしたデータを、RAMに溜めずにFeRAMなどの保存先へ直接書き込むクラスです。
+         * 書き込んだサイズ(進捗)も保存先に記録するので、PSMやリセットで中断しても、Rangeヘッダーを使って続きからダウンロードを再開できます。
+         *
+         * 保存先のbaseAddressから、進捗の記録(HEADER_SIZEバイト)、データの順に配置します。
+         */
+        template <typename MODULE, typename STORAGE, size_t CHUNK_SIZE = 512>
+        class ResumableDownloader
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief 進捗の記録のサイズ[バイト]
+             */
+            static constexpr size_t HEADER_SIZE = 16;
+
+        private:
+            static constexpr uint32_t MAGIC = 0x444c4457; // "WDLD"
+
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t id;         // CRC-32 of host, port and path
+                uint32_t totalSize;  // 0 if unknown
+                uint32_t cursor;     // Bytes written to storage
+            };
+            static_assert(sizeof(Header) == HEADER_SIZE);
+
+            MODULE &Module_;
+            STORAGE &Storage_;
+            int PdpContextId_;
+            int ConnectId_;
+            uint32_t BaseAddress_;
+            size_t Capacity_;
+            Header Header_;
+            int HttpStatus_;
+            std::array<uint8_t, CHUNK_SIZE> Chunk_;
+
+            bool loadHeader(void)
+            {
+                return Storage_.readBuffer(BaseAddress_, reinterpret_cast<uint8_t *>(&Header_), sizeof(Header_)) == sizeof(Header_);
+            }
+
+            bool saveHeader(void)
+            {
+                return Storage_.writeBuffer(BaseAddress_, reinterpret_cast<const uint8_t *>(&Header_), sizeof(Header_)) == sizeof(Header_);
+            }
+
+            bool writeData(const uint8_t *data, size_t dataSize)
+            {
+                if (Header_.cursor + dataSize > Capacity_)
+                    return false;
+                if (Storage_.writeBuffer(BaseAddress_ + HEADER_SIZE + Header_.cursor, data, dataSize) != dataSize)
+                    return false;
+
+                // Advance the cursor only after the data has been written
+                Header_.cursor += dataSize;
+                return saveHeader();
+            }
+
+            static bool findHeaderValue(const std::string &headers, const char *name, std::string *value)
+            {
+                const std::string key = internal::stringFormat("\r\n%s:", name);
+                auto begin = headers.size();
+                for (size_t i = 0; i + key.size() <= headers.size(); ++i)
+                {
+                    if (strncasecmp(&headers[i], key.c_str(), key.size()) == 0)
+                    {
+                        begin = i + key.size();
+                        break;
+                    }
+                }
+                if (begin >= headers.size())
+                    return false;
+
+                while (begin < headers.size() && headers[begin] == ' ')
+                    ++begin;
+                const auto end = headers.find("\r\n", begin);
+                *value = headers.substr(begin, end - begin);
+                return true;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 10進数の値を解釈
+             *
+             * @param [in] str 文字列。
+             * @param [out] value 値。
+             * @param [out] end 値の直後の位置。nullptrを指定すると、値の後に空白以外があるときはエラーにします。
+             * @param [in] max 最大値。
+             * @retval true 成功
+             * @retval false 数字で始まらない、範囲外、または値の後に余計な文字がある
+             *
+             * リモートから受け取った値を解釈するため、例外を投げずにエラーを返します。
+             */
+            static bool parseDecimal(const char *str, uint32_t *value, const char **end = nullptr, uint32_t max = std::numeric_limits<uint32_t>::max())
+            {
+                // strtoul() accepts leading spaces and a sign
+                if (*str < '0' || '9' < *str)
+                    return false;
+
+                char *last;
+                errno = 0;
+                const auto number = strtoul(str, &last, 10);
+                if (errno == ERANGE || number > max)
+                    return false;
+
+                if (end)
+                {
+                    *end = last;
+                }
+                else
+                {
+                    while (*last == ' ' || *last == '\t')
+                        ++last;
+                    if (*last != '\0')
+                        return false;
+                }
+
+                *value = static_cast<uint32_t>(number);
+                return true;
+            }
+
+            /**
+             * @~Japanese
+             * @brief レスポンスヘッダーを解釈
+             *
+             * @param [in] headers ステータス行からヘッダーの終わりまで。
+             * @return 実行結果。
+             *
+             * ステータスコードと全体のサイズから、進捗を更新します。
+             */
+            WioCellularResult parseHeaders(const std::string &headers)
+            {
+                if (!internal::stringStartsWith(headers, "HTTP/1."))
+                    return WioCellularResult::CommandRejected;
+                const auto space = headers.find(' ');
+                if (space == std::string::npos)
+                    return WioCellularResult::CommandRejected;
+                uint32_t status;
+                const char *statusEnd;
+                if (!parseDecimal(&headers[space + 1], &status, &statusEnd, 999) || status < 100 || (*statusEnd != ' ' && *statusEnd != '\r'))
+                    return WioCellularResult::CommandRejected;
+                HttpStatus_ = static_cast<int>(status);
+
+                std::string value;
+                // The body is written to STORAGE as is, so chunk framing must not reach it
+                if (findHeaderValue(headers, "Transfer-Encoding", &value) && strcasecmp(value.c_str(), "identity") != 0)
+                    return WioCellularResult::CommandRejected;
+
+                switch (HttpStatus_)
+                {
+                case 206: // Partial Content
+                {
+                    // Content-Range: bytes <start>-<end>/<total>
+                    if (!findHeaderValue(headers, "Content-Range", &value) || !internal::stringStartsWith(value, "bytes "))
+                        return WioCellularResult::CommandRejected;
+                    uint32_t first;
+                    uint32_t last;
+                    const char *p;
+                    if (!parseDecimal(value.c_str() + 6, &first, &p) || *p != '-')
+                        return WioCellularResult::CommandRejected;
+                    if (!parseDecimal(p + 1, &last, &p) || *p != '/' || last < first)
+                        return WioCellularResult::CommandRejected;
+                    if (first != Header_.cursor)
+                        return WioCellularResult::CommandRejected;
+                    if (strcmp(p + 1, "*") != 0)
+                    {
+                        uint32_t total;
+                        if (!parseDecimal(p + 1, &total) || total <= last)
+                            return WioCellularResult::CommandRejected;
+                        Header_.totalSize = total;
+                    }
+                    break;
+                }
+                case 200: // OK (Range ignored)
+                {
+                    uint32_t total = 0;
+                    if (findHeaderValue(headers, "Content-Length", &value) && !parseDecimal(value.c_str(), &total))
+                        return WioCellularResult::CommandRejected;
+                    Header_.cursor = 0;
+                    Header_.totalSize = total;
+                    break;
+                }
+                case 416: // Range Not Satisfiable
+                    // Content-Range: bytes */<total>
+                    if (findHeaderValue(headers, "Content-Range", &value))
+                    {
+                        const auto slash = value.find('/');
+                        uint32_t total;
+                        if (slash == std::string::npos || !parseDecimal(value.c_str() + slash + 1, &total))
+                            return WioCellularResult::CommandRejected;
+                        if (total == Header_.cursor)
+                        {
+                            Header_.totalSize = Header_.cursor;
+                            break;
+                        }
+                    }
+                    Header_.cursor = 0;
+                    Header_.totalSize = 0;
+                    saveHeader();
+                    return WioCellularResult::CommandRejected;
+                default:
+                    return WioCellularResult::CommandRejected;
+                }
+
+                if (Header_.totalSize > Capacity_)
+                    return WioCellularResult::CommandRejected;
+
+                return saveHeader() ? WioCellularResult::Ok : WioCellularResult::CommandRejected;
+            }
+
+            WioCellularResult transfer(const std::string &host, const std::string &path, int timeout)
+            {
+                WioCellularResult result;
+
+                const auto request = internal::stringFormat("GET %s HTTP/1.0\r\nHost: %s\r\nRange: bytes=%lu-\r\nConnection: close\r\n\r\n", path.c_str(), host.c_str(), static_cast<unsigned long>(Header_.cursor));
+                if ((result = Module_.sendSocket(ConnectId_, request.data(), request.size())) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+
+                const auto start = millis();
+                bool headerReceived = false;
+                size_t chunkUsed = 0; // Bytes of the response header held in Chunk_
+                bool modulePending = false;
+                while (!(headerReceived && Header_.totalSize >= 1 && Header_.cursor >= Header_.totalSize))
+                {
+                    if (!modulePending && !Module_.isSocketReceiveNotified(ConnectId_))
+                    {
+                        if (Module_.isSocketClosedNotified(ConnectId_))
+                            break;
+                        if (millis() - start >= static_cast<uint32_t>(timeout))
+                            return WioCellularResult::ReceiveTimeout;
+                        Module_.doWork(timeout - (millis() - start));
+                        continue;
+                    }
+
+                    const auto requestSize = Chunk_.size() - chunkUsed;
+                    size_t size;
+                    if ((result = Module_.receiveSocket(ConnectId_, &Chunk_[chunkUsed], requestSize, &size)) != WioCellularResult::Ok)
+                    {
+                        return result;
+                    }
+                    // The module does not notify again until its buffer has been read dry
+                    modulePending = size >= requestSize;
+
+                    if (headerReceived)
+                    {
+                        if (!writeData(Chunk_.data(), size))
+                            return WioCellularResult::CommandRejected;
+                        continue;
+                    }
+
+                    chunkUsed += size;
+                    const std::string received(reinterpret_cast<const char *>(Chunk_.data()), chunkUsed);
+                    const auto headerEnd = received.find("\r\n\r\n");
+                    if (headerEnd == std::string::npos)
+                    {
+                        if (chunkUsed >= Chunk_.size())
+                            return WioCellularResult::CommandRejected; // Header too large
+                        continue;
+                    }
+
+                    if ((result = parseHeaders(received.substr(0, headerEnd + 2))) != WioCellularResult::Ok)
+                    {
+                        return result;
+                    }
+                    headerReceived = true;
+                    const auto bodyStart = headerEnd + 4;
+                    if (chunkUsed > bodyStart && !writeData(&Chunk_[bodyStart], chunkUsed - bodyStart))
+                        return WioCellularResult::CommandRejected;
+                    chunkUsed = 0;
+                }
+
+                if (!headerReceived)
+                    return WioCellularResult::ReceiveTimeout;
+                if (Header_.totalSize == 0)
+                {
+                    // Without Content-Length, the end of the data is the close by the server
+                    Header_.totalSize = Header_.cursor;
+                    saveHeader();
+                }
+                if (Header_.cursor < Header_.totalSize)
+                    return WioCellularResult::ReceiveTimeout;
+
+                return WioCellularResult::Ok;
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             * @param [in] storage 保存先のインスタンス。
+             * @param [in] pdpContextId PDPコンテキストID。
+             * @param [in] connectId 接続ID。
+             * @param [in] baseAddress 保存先の先頭アドレス。
+             * @param [in] capacity 保存できるデータの最大サイズ[バイト]。進捗の記録を除きます。
+             *
+             * コンストラクタ。
+             */
+            ResumableDownloader(MODULE &module, STORAGE &storage, int pdpContextId, int connectId, uint32_t baseAddress, size_t capacity)
+                : Module_{module},
+                  Storage_{storage},
+                  PdpContextId_{pdpContextId},
+                  ConnectId_{connectId},
+                  BaseAddress_{baseAddress},
+                  Capacity_{capacity},
+                  Header_{},
+                  HttpStatus_{-1},
+                  Chunk_{}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief ダウンロード
+             *
+             * @param [in] host ホスト名もしくはIPアドレス。
+             * @param [in] port ポート番号。
+             * @param [in] path パス。
+             * @param [in] timeout 受信のタイムアウト時間[ミリ秒]。
+             * @return 実行結果。
+             *
+             * HTTPでダウンロードして、保存先へ書き込みます。
+             * 保存先に同じホスト、ポート、パスの途中までの進捗があるときは、続きから再開します。
+             * 既にダウンロードが完了しているときは、通信せずに戻ります。
+             * 中断したときは、もう一度呼び出すと続きから再開します。
+             */
+            WioCellularResult download(const std::string &host, int port, const std::string &path, int timeout)
+            {
+                assert(!host.empty());
+                assert(!path.empty());
+
+                const auto target = internal::stringFormat("%s:%d%s", host.c_str(), port, path.c_str());
+                const auto id = internal::crc32(target.data(), target.size());
+
+                if (!loadHeader())
+                    return WioCellularResult::CommandRejected;
+                if (Header_.magic != MAGIC || Header_.id != id || Header_.cursor > Capacity_)
+                {
+                    Header_ = {MAGIC, id, 0, 0};
+                    if (!saveHeader())
+                        return WioCellularResult::CommandRejected;
+                }
+                if (isCompleted())
+                    return WioCellularResult::Ok;
+
+                WioCellularResult result;
+
+                if ((result = Module_.openSocket(PdpContextId_, ConnectId_, "TCP", host, port, 0)) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+                result = transfer(host, path, timeout);
+                Module_.closeSocket(ConnectId_);
+
+                return result;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 進捗を破棄
+             *
+             * @return 実行結果。
+             *
+             * 保存先の進捗を破棄して、次のdownload()を最初からにします。
+             */
+            WioCellularResult reset(void)
+            {
+                Header_ = {};
+                return saveHeader() ? WioCellularResult::Ok : WioCellularResult::CommandRejected;
+            }
+
+            /**
+             * @~Japanese
+             * @brief ダウンロードの完了を取得
+             *
+             * @retval true 完了
+             * @retval false 未完了
+             *
+             * 最後のdownload()でダウンロードが完了したかを取得します。
+             */
+            bool isCompleted(void) const
+            {
+                return Header_.magic == MAGIC && Header_.totalSize >= 1 && Header_.cursor >= Header_.totalSize;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 書き込んだサイズを取得
+             *
+             * @return 保存先へ書き込んだサイズ[バイト]。
+             *
+             * 保存先へ書き込んだサイズを取得します。
+             */
+            size_t getReceivedSize(void) const
+            {
+                return Header_.cursor;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 全体のサイズを取得
+             *
+             * @return 全体のサイズ[バイト]。不明なときは0。
+             *
+             * ダウンロードするデータ全体のサイズを取得します。
+             */
+            size_t getTotalSize(void) const
+            {
+                return Header_.totalSize;
+            }
+
+            /**
+             * @~Japanese
+             * @brief HTTPステータスコードを取得
+             *
+             * @return 最後のレスポンスのHTTPステータスコード。
+             *
+             * 最後のレスポンスのHTTPステータスコードを取得します。
+             */
+            int getHttpStatus(void) const
+            {
+                return HttpStatus_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief データの先頭アドレスを取得
+             *
+             * @return 保存先でのデータの先頭アドレス。
+             *
+             * ダウンロードしたデータが置かれている、保存先のアドレスを取得します。
+             */
+            uint32_t getDataAddress(void) const
+            {
+                return BaseAddress_ + HEADER_SIZE;
+            }
+        };
+
+    }
+}
+
+#endif // RESUMABLEDOWNLOADER_HPP
@@ -0,0 +1,302 @@
+/*
+ * SignalQualitySampler.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef SIGNALQUALITYSAMPLER_HPP
+#define SIGNALQUALITYSAMPLER_HPP
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] 受信品質を記録するクラス
+         *
+         * @tparam MODULE モジュールのクラス
+         * @tparam SAMPLE_COUNT 記録するサンプル数
+         *
+         * AT+QCSQで取得したLTEの受信品質(RSSI、RSRP、SINR、RSRQ)を、最新のSAMPLE_COUNT個だけ記録して統計を計算するクラスです。
+         * 送信の前後など、モジュールが起きているときにsample()を呼び出すと、余計なウェイクアップ無しで記録できます。
+         * 統計を見て、受信品質が良いときだけ大きなデータを送信するといった使い方ができます。
+         */
+        template <typename MODULE, size_t SAMPLE_COUNT = 32>
+        class SignalQualitySampler
+        {
+            static_assert(SAMPLE_COUNT >= 1);
+
+        public:
+            /**
+             * @~Japanese
+             * @brief 受信品質の種類
+             */
+            enum class Metric
+            {
+                /**
+                 * @~Japanese
+                 * @brief RSSI[dBm]
+                 */
+                Rssi,
+                /**
+                 * @~Japanese
+                 * @brief RSRP[dBm]
+                 */
+                Rsrp,
+                /**
+                 * @~Japanese
+                 * @brief SINR[1/5dB]
+                 */
+                Sinr,
+                /**
+                 * @~Japanese
+                 * @brief RSRQ[dB]
+                 */
+                Rsrq,
+            };
+
+            /**
+             * @~Japanese
+             * @brief サンプル
+             */
+            struct Sample
+            {
+                /**
+                 * @~Japanese
+                 * @brief 取得した時刻。millis()の値。
+                 */
+                uint32_t time;
+                /**
+                 * @~Japanese
+                 * @brief 受信品質。Metricの順。
+                 */
+                std::array<int16_t, 4> values;
+            };
+
+            /**
+             * @~Japanese
+             * @brief 統計
+             */
+            struct Statistics
+            {
+                /**
+                 * @~Japanese
+                 * @brief サンプル数
+                 */
+                size_t count;
+                /**
+                 * @~Japanese
+                 * @brief 最小値
+                 */
+                int min;
+                /**
+                 * @~Japanese
+                 * @brief 最大値
+                 */
+                int max;
+                /**
+                 * @~Japanese
+                 * @brief 平均値
+                 */
+                float mean;
+            };
+
+        private:
+            static constexpr size_t METRIC_COUNT = 4;
+
+            MODULE &Module_;
+            std::array<Sample, SAMPLE_COUNT> Samples_;
+            size_t Next_;
+            size_t Count_;
+            std::array<int32_t, METRIC_COUNT> Sums_;
+            bool Sampled_;
+            uint32_t LastSampleTime_;
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             *
+             * コンストラクタ。
+             */
+            explicit SignalQualitySampler(MODULE &module)
+                : Module_{module},
+                  Samples_{},
+                  Next_{0},
+                  Count_{0},
+                  Sums_{},
+                  Sampled_{false},
+                  LastSampleTime_{0}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief 受信品質を記録
+             *
+             * @param [in] minInterval 前回の記録からの最小間隔[ミリ秒]。
+             * @return 実行結果。
+             *
+             * 前回の記録からminInterval以上経過していれば、AT+QCSQで受信品質を取得して記録します。
+             * 経過していないときと、圏外のときは記録しません。
+             * モジュールが起きているときに呼び出してください。
+             */
+            WioCellularResult sample(uint32_t minInterval = 0)
+            {
+                const uint32_t now = millis();
+                if (Sampled_ && now - LastSampleTime_ < minInterval)
+                    return WioCellularResult::Ok;
+
+                WioCellularResult result;
+
+                std::string sysmode;
+                int rssi;
+                int rsrp;
+                int sinr;
+                int rsrq;
+                if ((result = Module_.getExtendedSignalQuality(&sysmode, &rssi, &rsrp, &sinr, &rsrq)) != WioCellularResult::Ok)
+                    return result;
+
+                Sampled_ = true;
+                LastSampleTime_ = now;
+                if (sysmode != "eMTC" && sysmode != "NBIoT")
+                    return WioCellularResult::Ok;
+
+                add({now, {static_cast<int16_t>(rssi), static_cast<int16_t>(rsrp), static_cast<int16_t>(sinr), static_cast<int16_t>(rsrq)}});
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief サンプルを追加
+             *
+             * @param [in] sample サンプル。
+             *
+             * サンプルを追加します。SAMPLE_COUNT個を超えたときは、最も古いサンプルを捨てます。
+             */
+            void add(const Sample &sample)
+            {
+                if (Count_ >= SAMPLE_COUNT)
+                {
+                    for (size_t i = 0; i < METRIC_COUNT; ++i)
+                        Sums_[i] -= Samples_[Next_].values[i];
+                }
+                else
+                {
+                    ++Count_;
+                }
+
+                Samples_[Next_] = sample;
+                for (size_t i = 0; i < METRIC_COUNT; ++i)
+                    Sums_[i] += sample.values[i];
+                Next_ = (Next_ + 1) % SAMPLE_COUNT;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 全てのサンプルを削除
+             */
+            void clear(void)
+            {
+                Next_ = 0;
+                Count_ = 0;
+                Sums_.fill(0);
+            }
+
+            /**
+             * @~Japanese
+             * @brief サンプル数を取得
+             *
+             * @return サンプル数。
+             */
+            size_t size(void) const
+            {
+                return Count_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 最新のサンプルを取得
+             *
+             * @return 最新のサンプル。
+             *
+             * サンプルが無いときは呼び出さないでください。
+             */
+            const Sample &latest(void) const
+            {
+                assert(Count_ >= 1);
+
+                return Samples_[(Next_ + SAMPLE_COUNT - 1) % SAMPLE_COUNT];
+            }
+
+            /**
+             * @~Japanese
+             * @brief 統計を取得
+             *
+             * @param [in] metric 受信品質の種類。
+             * @return 統計。
+             *
+             * 記録しているサンプルの最小値、最大値、平均値を取得します。
+             * 平均値は記録時に更新する合計から計算するので、サンプル数に関係なく高速です。
+             */
+            Statistics getStatistics(Metric metric) const
+            {
+                const auto index = static_cast<size_t>(metric);
+                if (Count_ == 0)
+                    return {0, 0, 0, 0.0f};
+
+                int min = Samples_[0].values[index];
+                int max = Samples_[0].values[index];
+                for (size_t i = 1; i < Count_; ++i)
+                {
+                    min = std::min<int>(min, Samples_[i].values[index]);
+                    max = std::max<int>(max, Samples_[i].values[index]);
+                }
+
+                return {Count_, min, max, static_cast<float>(Sums_[index]) / Count_};
+            }
+
+            /**
+             * @~Japanese
+             * @brief パーセンタイルを取得
+             *
+             * @param [in] metric 受信品質の種類。
+             * @param [in] percent パーセント。0~100。
+             * @return パーセンタイルの値。サンプルが無いときは0。
+             *
+             * 記録しているサンプルのパーセンタイル(最近傍法)を取得します。50で中央値です。
+             */
+            int getPercentile(Metric metric, int percent) const
+            {
+                assert(0 <= percent && percent <= 100);
+
+                if (Count_ == 0)
+                    return 0;
+
+                const auto index = static_cast<size_t>(metric);
+                std::array<int16_t, SAMPLE_COUNT> values;
+                for (size_t i = 0; i < Count_; ++i)
+                    values[i] = Samples_[i].values[index];
+
+                const size_t rank = (percent * Count_ + 99) / 100;
+                const auto nth = values.begin() + (rank >= 1 ? rank - 1 : 0);
+                std::nth_element(values.begin(), nth, values.begin() + Count_);
+
+                return *nth;
+            }
+        };
+
+    }
+}
+
+#endif // SIGNALQUALITYSAMPLER_HPP
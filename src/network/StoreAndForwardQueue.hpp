@@ -0,0 +1,493 @@
+/*
+ * StoreAndForwardQueue.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef STOREANDFORWARDQUEUE_HPP
+#define STOREANDFORWARDQUEUE_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include "internal/Crc32.hpp"
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] 不揮発メモリに保存する送信待ちキュー
+         *
+         * @tparam STORAGE 保存先のクラス。readBuffer(address, buffer, size)とwriteBuffer(address, buffer, size)を持つクラス。例: Adafruit_SPIFlash
+         * @tparam BATCH_SIZE まとめて送信する最大サイズ[バイト]
+         *
+         * 通信できない間のレコードをFeRAMなどに保存して、通信できるようになったらまとめて送信するFIFOです。
+         * 保存先をリングバッファとして使い、レコード毎にCRC-32を付けて書き込みます。
+         * 先頭と末尾の位置は2か所に交互に記録するので、書き込み中に電源が切れても直前の状態に戻ります。
+         * FeRAMは消去が不要なので、追加の度に位置を記録しても高速です。
+         *
+         * 保存先のbaseAddressから、位置の記録(METADATA_SIZEバイト)、レコードの順に配置します。
+         */
+        template <typename STORAGE, size_t BATCH_SIZE = 1460>
+        class StoreAndForwardQueue
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief 位置の記録のサイズ[バイト]
+             */
+            static constexpr size_t METADATA_SIZE = 64;
+
+            /**
+             * @~Japanese
+             * @brief レコードの最大サイズ[バイト]
+             */
+            static constexpr size_t RECORD_SIZE_MAX = BATCH_SIZE;
+
+            /**
+             * @~Japanese
+             * @brief 送信する関数の型
+             *
+             * まとめたレコードを受け取り、送信結果を返します。
+             */
+            using SendType = std::function<WioCellularResult(const void *data, size_t dataSize)>;
+
+            /**
+             * @~Japanese
+             * @brief キューの設定
+             */
+            struct
+            {
+                /**
+                 * @~Japanese
+                 * @brief 満杯のとき古いレコードを捨てる
+                 */
+                bool overwriteOldest;
+            } config;
+
+        private:
+            static constexpr uint32_t MAGIC = 0x51464157; // "WAFQ"
+            static constexpr size_t SLOT_SIZE = METADATA_SIZE / 2;
+            static constexpr size_t RECORD_HEADER_SIZE = 8;
+
+            struct Metadata
+            {
+                uint32_t magic;
+                uint32_t sequence;
+                uint32_t head; // Total bytes removed
+                uint32_t tail; // Total bytes appended
+                uint32_t count;
+                uint32_t crc;
+            };
+            static_assert(sizeof(Metadata) <= SLOT_SIZE);
+
+            STORAGE &Storage_;
+            uint32_t BaseAddress_;
+            size_t DataSize_;
+            Metadata Metadata_;
+            size_t DroppedCount_;
+            std::array<uint8_t, BATCH_SIZE> Batch_;
+
+            static uint32_t metadataCrc(const Metadata &metadata)
+            {
+                return internal::crc32(&metadata, offsetof(Metadata, crc));
+            }
+
+            bool readRing(uint32_t position, void *data, size_t dataSize)
+            {
+                const auto offset = position % DataSize_;
+                const auto first = dataSize < DataSize_ - offset ? dataSize : DataSize_ - offset;
+                auto p = static_cast<uint8_t *>(data);
+                if (Storage_.readBuffer(BaseAddress_ + METADATA_SIZE + offset, p, first) != first)
+                    return false;
+                if (first < dataSize && Storage_.readBuffer(BaseAddress_ + METADATA_SIZE, p + first, dataSize - first) != dataSize - first)
+                    return false;
+                return true;
+            }
+
+            bool writeRing(uint32_t position, const void *data, size_t dataSize)
+            {
+                const auto offset = position % DataSize_;
+                const auto first = dataSize < DataSize_ - offset ? dataSize : DataSize_ - offset;
+                auto p = static_cast<const uint8_t *>(data);
+                if (Storage_.writeBuffer(BaseAddress_ + METADATA_SIZE + offset, p, first) != first)
+                    return false;
+                if (first < dataSize && Storage_.writeBuffer(BaseAddress_ + METADATA_SIZE, p + first, dataSize - first) != dataSize - first)
+                    return false;
+                return true;
+            }
+
+            bool commit(void)
+            {
+                ++Metadata_.sequence;
+                Metadata_.crc = metadataCrc(Metadata_);
+                const auto address = BaseAddress_ + (Metadata_.sequence % 2) * SLOT_SIZE;
+                return Storage_.writeBuffer(address, reinterpret_cast<const uint8_t *>(&Metadata_), sizeof(Metadata_)) == sizeof(Metadata_);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 先頭のレコードのヘッダーを読み込み
+             *
+             * @param [out] size レコードのサイズ。
+             * @param [out] crc レコードのCRC-32。
+             * @retval true 成功
+             * @retval false ヘッダーが壊れている
+             */
+            bool readRecordHeader(uint32_t position, size_t *size, uint32_t *crc)
+            {
+                uint8_t header[RECORD_HEADER_SIZE];
+                if (!readRing(position, header, sizeof(header)))
+                    return false;
+                const uint16_t recordSize = header[0] | header[1] << 8;
+                const uint16_t inverted = header[2] | header[3] << 8;
+                if (static_cast<uint16_t>(~recordSize) != inverted || recordSize > RECORD_SIZE_MAX || RECORD_HEADER_SIZE + recordSize > Metadata_.tail - position)
+                    return false;
+                *size = recordSize;
+                *crc = header[4] | header[5] << 8 | header[6] << 16 | static_cast<uint32_t>(header[7]) << 24;
+                return true;
+            }
+
+            bool dropOldest(void)
+            {
+                size_t size;
+                uint32_t crc;
+                if (!readRecordHeader(Metadata_.head, &size, &crc))
+                {
+                    // Nothing after a broken header can be trusted
+                    Metadata_.head = Metadata_.tail;
+                    Metadata_.count = 0;
+                }
+                else
+                {
+                    Metadata_.head += RECORD_HEADER_SIZE + size;
+                    --Metadata_.count;
+                }
+                ++DroppedCount_;
+                return commit();
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] storage 保存先のインスタンス。
+             * @param [in] baseAddress 保存先の先頭アドレス。
+             * @param [in] size 使用するサイズ[バイト]。位置の記録を含みます。
+             *
+             * コンストラクタ。
+             */
+            StoreAndForwardQueue(STORAGE &storage, uint32_t baseAddress, size_t size)
+                : config{true},
+                  Storage_{storage},
+                  BaseAddress_{baseAddress},
+                  DataSize_{size - METADATA_SIZE},
+                  Metadata_{},
+                  DroppedCount_{0},
+                  Batch_{}
+            {
+                assert(size > METADATA_SIZE + RECORD_HEADER_SIZE + RECORD_SIZE_MAX);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 開始
+             *
+             * @return 実行結果。
+             *
+             * 保存先から位置の記録を読み込みます。
+             * 2か所の記録のうち、正しくて新しい方を使います。どちらも正しくないときは空のキューを作ります。
+             */
+            WioCellularResult begin(void)
+            {
+                Metadata slots[2];
+                bool valid[2];
+                for (int i = 0; i < 2; ++i)
+                {
+                    valid[i] = Storage_.readBuffer(BaseAddress_ + i * SLOT_SIZE, reinterpret_cast<uint8_t *>(&slots[i]), sizeof(slots[i])) == sizeof(slots[i]) &&
+                               slots[i].magic == MAGIC && slots[i].crc == metadataCrc(slots[i]) &&
+                               slots[i].tail - slots[i].head <= DataSize_;
+                }
+
+                if (valid[0] && valid[1])
+                    Metadata_ = static_cast<int32_t>(slots[1].sequence - slots[0].sequence) > 0 ? slots[1] : slots[0];
+                else if (valid[0] || valid[1])
+                    Metadata_ = valid[0] ? slots[0] : slots[1];
+                else
+                {
+                    Metadata_ = {MAGIC, 0, 0, 0, 0, 0};
+                    if (!commit())
+                        return WioCellularResult::CommandRejected;
+                }
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief レコードを追加
+             *
+             * @param [in] data データ。
+             * @param [in] dataSize データサイズ。RECORD_SIZE_MAX以下。
+             * @return 実行結果。
+             *
+             * 末尾にレコードを追加します。
+             * 空きが足りないときは、config.overwriteOldestがtrueなら古いレコードを捨て、falseならエラーを返します。
+             * レコードを書き込んでから位置を記録するので、途中で電源が切れたときはレコードが無かったことになります。
+             */
+            WioCellularResult push(const void *data, size_t dataSize)
+            {
+                assert(data);
+                assert(1 <= dataSize && dataSize <= RECORD_SIZE_MAX);
+
+                const auto recordSize = RECORD_HEADER_SIZE + dataSize;
+                while (DataSize_ - (Metadata_.tail - Metadata_.head) < recordSize)
+                {
+                    if (!config.overwriteOldest)
+                        return WioCellularResult::CommandRejected;
+                    if (!dropOldest())
+                        return WioCellularResult::CommandRejected;
+                }
+
+                const auto crc = internal::crc32(data, dataSize);
+                const uint8_t header[RECORD_HEADER_SIZE] = {
+                    static_cast<uint8_t>(dataSize),
+                    static_cast<uint8_t>(dataSize >> 8),
+                    static_cast<uint8_t>(~dataSize),
+                    static_cast<uint8_t>(~dataSize >> 8),
+                    static_cast<uint8_t>(crc),
+                    static_cast<uint8_t>(crc >> 8),
+                    static_cast<uint8_t>(crc >> 16),
+                    static_cast<uint8_t>(crc >> 24),
+                };
+                if (!writeRing(Metadata_.tail, header, sizeof(header)) || !writeRing(Metadata_.tail + RECORD_HEADER_SIZE, data, dataSize))
+                    return WioCellularResult::CommandRejected;
+
+                Metadata_.tail += recordSize;
+                ++Metadata_.count;
+                if (!commit())
+                    return WioCellularResult::CommandRejected;
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 先頭のレコードを読み込み
+             *
+             * @param [out] data データ。
+             * @param [in] dataSize データの最大サイズ。
+             * @param [out] readDataSize 読み込んだサイズ。
+             * @return 実行結果。
+             *
+             * 先頭のレコードを取り除かずに読み込みます。
+             * CRCが一致しないレコードは捨てて、次のレコードを読み込みます。
+             * レコードが無いときは*readDataSize=0を返します。
+             */
+            WioCellularResult front(void *data, size_t dataSize, size_t *readDataSize)
+            {
+                assert(data);
+                assert(readDataSize);
+
+                *readDataSize = 0;
+                while (Metadata_.head != Metadata_.tail)
+                {
+                    size_t size;
+                    uint32_t crc;
+                    if (!readRecordHeader(Metadata_.head, &size, &crc))
+                    {
+                        dropOldest();
+                        continue;
+                    }
+                    if (size > dataSize)
+                        return WioCellularResult::CommandRejected;
+                    if (!readRing(Metadata_.head + RECORD_HEADER_SIZE, data, size))
+                        return WioCellularResult::CommandRejected;
+                    if (internal::crc32(data, size) != crc)
+                    {
+                        dropOldest();
+                        continue;
+                    }
+                    *readDataSize = size;
+                    break;
+                }
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 先頭のレコードを取り除く
+             *
+             * @return 実行結果。
+             *
+             * 先頭のレコードを取り除きます。
+             */
+            WioCellularResult pop(void)
+            {
+                if (Metadata_.head == Metadata_.tail)
+                    return WioCellularResult::Ok;
+
+                size_t size;
+                uint32_t crc;
+                if (!readRecordHeader(Metadata_.head, &size, &crc))
+                {
+                    return dropOldest() ? WioCellularResult::Ok : WioCellularResult::CommandRejected;
+                }
+                Metadata_.head += RECORD_HEADER_SIZE + size;
+                --Metadata_.count;
+
+                return commit() ? WioCellularResult::Ok : WioCellularResult::CommandRejected;
+            }
+
+            /**
+             * @~Japanese
+             * @brief レコードをまとめて送信
+             *
+             * @param [in] send 送信する関数。
+             * @param [in] maxBatches 送信する最大回数。
+             * @return 実行結果。
+             *
+             * 先頭から、BATCH_SIZEに収まるだけのレコードを連結してsendへ渡し、成功したら取り除きます。
+             * レコードは区切らずに連結するので、受信側で区切れる形式(改行区切りなど)にしてください。
+             * 送信に失敗したときは、レコードを残したまま戻ります。
+             * 通信できるようになったとき(WioNetwork.canCommunicate())に、loop()から呼び出してください。
+             */
+            WioCellularResult drain(const SendType &send, int maxBatches = 1)
+            {
+                assert(send);
+
+                WioCellularResult result;
+
+                for (int batch = 0; batch < maxBatches && !empty(); ++batch)
+                {
+                    size_t batchSize = 0;
+                    uint32_t position = Metadata_.head;
+                    size_t batchCount = 0;
+                    while (position != Metadata_.tail)
+                    {
+                        size_t size;
+                        uint32_t crc;
+                        if (!readRecordHeader(position, &size, &crc) || batchSize + size > Batch_.size())
+                            break;
+                        if (!readRing(position + RECORD_HEADER_SIZE, &Batch_[batchSize], size))
+                            return WioCellularResult::CommandRejected;
+                        if (internal::crc32(&Batch_[batchSize], size) == crc)
+                            batchSize += size;
+                        else
+                            ++DroppedCount_;
+                        position += RECORD_HEADER_SIZE + size;
+                        ++batchCount;
+                    }
+                    if (batchCount == 0)
+                    {
+                        // Broken header at the head
+                        dropOldest();
+                        continue;
+                    }
+
+                    if (batchSize >= 1)
+                    {
+                        if ((result = send(Batch_.data(), batchSize)) != WioCellularResult::Ok)
+                        {
+                            return result;
+                        }
+                    }
+
+                    Metadata_.head = position;
+                    Metadata_.count -= batchCount;
+                    if (!commit())
+                        return WioCellularResult::CommandRejected;
+                }
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief レコードをまとめてソケットへ送信
+             *
+             * @tparam MODULE モジュールのクラス
+             * @param [in] module モジュールのインスタンス。
+             * @param [in] connectId オープン済みのソケットの接続ID。
+             * @param [in] maxBatches 送信する最大回数。
+             * @return 実行結果。
+             *
+             * drain()で、レコードをsendSocket()で送信します。
+             */
+            template <typename MODULE>
+            WioCellularResult drainToSocket(MODULE &module, int connectId, int maxBatches = 1)
+            {
+                return drain([&module, connectId](const void *data, size_t dataSize) -> WioCellularResult
+                             { return module.sendSocket(connectId, data, dataSize); },
+                             maxBatches);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 空かを取得
+             *
+             * @retval true 空
+             * @retval false レコードあり
+             */
+            bool empty(void) const
+            {
+                return Metadata_.head == Metadata_.tail;
+            }
+
+            /**
+             * @~Japanese
+             * @brief レコード数を取得
+             *
+             * @return レコード数。
+             */
+            size_t size(void) const
+            {
+                return Metadata_.count;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 使用しているサイズを取得
+             *
+             * @return レコードが使用しているサイズ[バイト]。
+             */
+            size_t usedSize(void) const
+            {
+                return Metadata_.tail - Metadata_.head;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 捨てたレコード数を取得
+             *
+             * @return 満杯や破損で捨てたレコード数。
+             */
+            size_t getDroppedCount(void) const
+            {
+                return DroppedCount_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 全てのレコードを取り除く
+             *
+             * @return 実行結果。
+             */
+            WioCellularResult clear(void)
+            {
+                Metadata_.head = Metadata_.tail;
+                Metadata_.count = 0;
+                return commit() ? WioCellularResult::Ok : WioCellularResult::CommandRejected;
+            }
+        };
+
+    }
+}
+
+#endif // STOREANDFORWARDQUEUE_HPP
@@ -0,0 +1,257 @@
+/*
+ * TcpConnectionManager.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef TCPCONNECTIONMANAGER_HPP
+#define TCPCONNECTIONMANAGER_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] TCP接続を維持するクラス
+         *
+         * @tparam MODULE モジュールのクラス
+         *
+         * 送信の度にオープンとクローズをせずに、TCP接続を維持して使い回すクラスです。
+         * TCPキープアライブを設定し、リモートからの切断をURC(+QIURC: "closed")で検出します。
+         * 切断されていたときは、次の送信時に接続し直します。
+         */
+        template <typename MODULE>
+        class TcpConnectionManager
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief 接続の設定
+             */
+            struct
+            {
+                /**
+                 * @~Japanese
+                 * @brief TCPキープアライブの有効
+                 */
+                bool keepalive;
+                /**
+                 * @~Japanese
+                 * @brief キープアライブを開始するまでの無通信時間[分]
+                 */
+                int keepaliveIdleTime;
+                /**
+                 * @~Japanese
+                 * @brief キープアライブの送信間隔[秒]
+                 */
+                int keepaliveInterval;
+                /**
+                 * @~Japanese
+                 * @brief 切断と判断するまでのキープアライブの再送回数
+                 */
+                int keepaliveProbeCount;
+            } config;
+
+        private:
+            MODULE &Module_;
+            int PdpContextId_;
+            int ConnectId_;
+            std::string Host_;
+            int Port_;
+            bool Opened_;
+            bool KeepaliveApplied_;
+
+            bool isSocketAlive(void)
+            {
+                // The closed URC is dropped when it arrives while another AT command is running, so ask the module
+                std::vector<typename MODULE::SocketStatus> statuses;
+                if (Module_.getSocketStatus(PdpContextId_, &statuses) != WioCellularResult::Ok)
+                    return false;
+
+                const auto status = std::find_if(statuses.begin(), statuses.end(), [this](const typename MODULE::SocketStatus &status)
+                                                 { return status.connectId == ConnectId_; });
+                return status != statuses.end() && status->socketState == 2; // Connected
+            }
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             * @param [in] pdpContextId PDPコンテキストID。
+             * @param [in] connectId 接続ID。
+             * @param [in] host 接続先のホスト名もしくはIPアドレス。
+             * @param [in] port 接続先のポート番号。
+             *
+             * コンストラクタ。
+             */
+            TcpConnectionManager(MODULE &module, int pdpContextId, int connectId, const std::string &host, int port)
+                : config{true, 10, 75, 3},
+                  Module_{module},
+                  PdpContextId_{pdpContextId},
+                  ConnectId_{connectId},
+                  Host_{host},
+                  Port_{port},
+                  Opened_{false},
+                  KeepaliveApplied_{false}
+            {
+            }
+
+            /**
+             * @~Japanese
+             * @brief 接続IDを取得
+             *
+             * @return 接続ID。
+             *
+             * 接続IDを取得します。
+             */
+            int getConnectId(void) const
+            {
+                return ConnectId_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 接続状態を取得
+             *
+             * @retval true 接続
+             * @retval false 切断
+             *
+             * 接続状態を取得します。
+             * URCの処理を行うだけで、ATコマンドは送信しません。
+             */
+            bool isConnected(void)
+            {
+                if (!Opened_)
+                    return false;
+
+                Module_.doWork(0); // Process pending URCs without sending AT command
+
+                return !Module_.isSocketClosedNotified(ConnectId_);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 接続
+             *
+             * @return 実行結果。
+             *
+             * 接続していないときだけ接続します。
+             * リモートから切断されていたときは、ソケットをクローズしてから接続し直します。
+             */
+            WioCellularResult connect(void)
+            {
+                if (isConnected())
+                    return WioCellularResult::Ok;
+
+                if (Opened_)
+                    close();
+
+                WioCellularResult result;
+
+                if (!KeepaliveApplied_)
+                {
+                    if ((result = Module_.setTcpKeepalive(config.keepalive, config.keepaliveIdleTime, config.keepaliveInterval, config.keepaliveProbeCount)) != WioCellularResult::Ok)
+                    {
+                        return result;
+                    }
+                    KeepaliveApplied_ = true;
+                }
+
+                if ((result = Module_.openSocket(PdpContextId_, ConnectId_, "TCP", Host_, Port_, 0)) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+                Opened_ = true;
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 切断
+             *
+             * ソケットをクローズします。
+             */
+            void close(void)
+            {
+                if (!Opened_)
+                    return;
+
+                Module_.closeSocket(ConnectId_);
+                Opened_ = false;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信
+             *
+             * @param [in] data データ。
+             * @param [in] dataSize データサイズ。
+             * @return 実行結果。
+             *
+             * 必要なら接続してから送信します。
+             * 送信に失敗したときは、AT+QISTATEでソケットの状態を問い合わせて、切断されていれば1度だけ接続し直して送信します。
+             * 接続したままのとき(モジュールの送信バッファが一杯など)は、二重に届かないよう送信し直さずにエラーを返します。
+             */
+            WioCellularResult send(const void *data, size_t dataSize)
+            {
+                WioCellularResult result;
+
+                if ((result = connect()) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+                if ((result = Module_.sendSocket(ConnectId_, data, dataSize)) == WioCellularResult::Ok)
+                {
+                    return result;
+                }
+
+                // Resending over a live connection would deliver the data twice
+                if (isConnected() && isSocketAlive())
+                {
+                    return result;
+                }
+
+                close();
+                if ((result = connect()) != WioCellularResult::Ok)
+                {
+                    return result;
+                }
+                return Module_.sendSocket(ConnectId_, data, dataSize);
+            }
+
+            /**
+             * @~Japanese
+             * @brief 受信
+             *
+             * @param [in,out] data データ。
+             * @param [in] dataSize データサイズ。
+             * @param [out] readDataSize 受信したデータサイズ。
+             * @param [in] timeout タイムアウト時間[ミリ秒]。
+             * @return 実行結果。
+             *
+             * 受信します。
+             * 接続していないときはWioCellularResult::OpenErrorを返します。
+             */
+            WioCellularResult receive(void *data, size_t dataSize, size_t *readDataSize, int timeout)
+            {
+                if (!Opened_)
+                    return WioCellularResult::OpenError;
+
+                return Module_.receiveSocket(ConnectId_, data, dataSize, readDataSize, timeout);
+            }
+        };
+
+    }
+}
+
+#endif // TCPCONNECTIONMANAGER_HPP
@@ -0,0 +1,304 @@
+/*
+ * UplinkBatcher.hpp
+ * Copyright (C) Seeed K.K.
+ * MIT License
+ */
+
+#ifndef UPLINKBATCHER_HPP
+#define UPLINKBATCHER_HPP
+
+#include <array>
+#include <cstring>
+#include <string>
+#include "WioCellularResult.hpp"
+
+namespace wiocellular
+{
+    namespace network
+    {
+
+        /**
+         * @~Japanese
+         * @brief [Experimental] 送信をまとめるクラス
+         *
+         * @tparam MODULE モジュールのクラス
+         * @tparam ARENA_SIZE まとめるデータの最大サイズ[バイト]
+         *
+         * 追加したレコードを確保済みの領域に溜めて、まとめて送信するクラスです。
+         * 溜めたサイズがpolicy.maxBytesを超えたとき、最初のレコードからpolicy.maxAgeが経過したとき、setDeadline()で指定した時刻になったときに送信します。
+         * 1回の送信で、ソケットのオープン、送信、クローズを1回だけ行います。UDPのときは1つのデータグラムになります。
+         * レコードは区切らずに連結するので、受信側で区切れる形式(改行区切りなど)にしてください。
+         *
+         * policyで、遅延と無線をオンにしている時間のどちらを優先するか調整できます。
+         */
+        template <typename MODULE, size_t ARENA_SIZE = 1460>
+        class UplinkBatcher
+        {
+        public:
+            /**
+             * @~Japanese
+             * @brief 送信する条件
+             */
+            struct
+            {
+                /**
+                 * @~Japanese
+                 * @brief 送信するサイズ[バイト]
+                 *
+                 * 溜めたサイズがこの値以上になったら送信します。
+                 */
+                size_t maxBytes;
+                /**
+                 * @~Japanese
+                 * @brief 最初のレコードを溜めておく最大時間[ミリ秒]
+                 *
+                 * 0のときは時間で送信しません。
+                 */
+                uint32_t maxAge;
+            } policy;
+
+        private:
+            static constexpr size_t SEND_SIZE_MAX = 1460;
+
+            MODULE &Module_;
+            int PdpContextId_;
+            std::string ServiceType_;
+            std::string Host_;
+            int Port_;
+
+            std::array<uint8_t, ARENA_SIZE> Arena_;
+            size_t Size_;
+            size_t RecordCount_;
+            uint32_t FirstRecordTime_;
+            bool DeadlineEnabled_;
+            uint32_t Deadline_;
+
+            size_t FlushCount_;
+            size_t FlushedSize_;
+
+        public:
+            /**
+             * @~Japanese
+             * @brief コンストラクタ
+             *
+             * @param [in] module モジュールのインスタンス。
+             * @param [in] pdpContextId PDPコンテキストID。
+             * @param [in] serviceType サービス種別。"TCP"もしくは"UDP"。
+             * @param [in] host 送信先のホスト名もしくはIPアドレス。
+             * @param [in] port 送信先のポート番号。
+             *
+             * コンストラクタ。
+             */
+            UplinkBatcher(MODULE &module, int pdpContextId, const std::string &serviceType, const std::string &host, int port)
+                : policy{ARENA_SIZE, 60000},
+                  Module_{module},
+                  PdpContextId_{pdpContextId},
+                  ServiceType_{serviceType},
+                  Host_{host},
+                  Port_{port},
+                  Arena_{},
+                  Size_{0},
+                  RecordCount_{0},
+                  FirstRecordTime_{0},
+                  DeadlineEnabled_{false},
+                  Deadline_{0},
+                  FlushCount_{0},
+                  FlushedSize_{0}
+            {
+                assert(serviceType == "TCP" || serviceType == "UDP");
+                assert(serviceType != "UDP" || ARENA_SIZE <= SEND_SIZE_MAX);
+            }
+
+            /**
+             * @~Japanese
+             * @brief レコードを追加
+             *
+             * @param [in] data データ。
+             * @param [in] dataSize データサイズ。ARENA_SIZE以下。
+             * @return 実行結果。
+             *
+             * レコードを溜めます。入りきらないときは、溜めていたレコードを送信してから追加します。
+             * 送信に失敗したときは、レコードを追加せずにエラーを返します。
+             * 追加後に送信する条件を満たしたときは、送信します。
+             */
+            WioCellularResult add(const void *data, size_t dataSize)
+            {
+                assert(data);
+                assert(dataSize <= ARENA_SIZE);
+
+                WioCellularResult result;
+
+                if (Size_ + dataSize > ARENA_SIZE)
+                {
+                    if ((result = flush()) != WioCellularResult::Ok)
+                        return result;
+                }
+
+                if (RecordCount_ == 0)
+                    FirstRecordTime_ = millis();
+                memcpy(&Arena_[Size_], data, dataSize);
+                Size_ += dataSize;
+                ++RecordCount_;
+
+                return process();
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信する期限を設定
+             *
+             * @param [in] deadline 期限。millis()の値。
+             *
+             * 溜めているレコードを、遅くともdeadlineまでに送信します。
+             * 送信すると期限は解除されます。
+             */
+            void setDeadline(uint32_t deadline)
+            {
+                if (!DeadlineEnabled_ || static_cast<int32_t>(deadline - Deadline_) < 0)
+                    Deadline_ = deadline;
+                DeadlineEnabled_ = true;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信する条件を満たしたかを取得
+             *
+             * @retval true 送信する
+             * @retval false 溜めておく
+             */
+            bool isFlushDue(void) const
+            {
+                if (RecordCount_ == 0)
+                    return false;
+
+                const auto now = millis();
+                if (Size_ >= policy.maxBytes)
+                    return true;
+                if (policy.maxAge >= 1 && now - FirstRecordTime_ >= policy.maxAge)
+                    return true;
+                if (DeadlineEnabled_ && static_cast<int32_t>(now - Deadline_) >= 0)
+                    return true;
+
+                return false;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 条件を満たしていれば送信
+             *
+             * @return 実行結果。
+             *
+             * 送信する条件を満たしていれば送信します。
+             * 時間の条件を確認するため、loop()から定期的に呼び出してください。
+             */
+            WioCellularResult process(void)
+            {
+                if (!isFlushDue())
+                    return WioCellularResult::Ok;
+
+                return flush();
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信
+             *
+             * @return 実行結果。
+             *
+             * 溜めているレコードを送信します。
+             * ソケットをオープンして送信し、クローズします。失敗したときはレコードを残します。
+             */
+            WioCellularResult flush(void)
+            {
+                if (RecordCount_ == 0)
+                    return WioCellularResult::Ok;
+
+                WioCellularResult result;
+
+                int connectId;
+                if ((result = Module_.getSocketUnusedConnectId(PdpContextId_, &connectId)) != WioCellularResult::Ok)
+                    return result;
+                if ((result = Module_.openSocket(PdpContextId_, connectId, ServiceType_, Host_, Port_, 0)) != WioCellularResult::Ok)
+                    return result;
+
+                for (size_t offset = 0; offset < Size_;)
+                {
+                    const auto sendSize = Size_ - offset < SEND_SIZE_MAX ? Size_ - offset : SEND_SIZE_MAX;
+                    if ((result = Module_.sendSocket(connectId, &Arena_[offset], sendSize)) != WioCellularResult::Ok)
+                        break;
+                    offset += sendSize;
+                }
+
+                const auto closeResult = Module_.closeSocket(connectId);
+                if (result != WioCellularResult::Ok)
+                    return result;
+                if (closeResult != WioCellularResult::Ok)
+                    return closeResult;
+
+                ++FlushCount_;
+                FlushedSize_ += Size_;
+                clear();
+
+                return WioCellularResult::Ok;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 溜めているレコードを破棄
+             */
+            void clear(void)
+            {
+                Size_ = 0;
+                RecordCount_ = 0;
+                DeadlineEnabled_ = false;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 溜めているサイズを取得
+             *
+             * @return 溜めているサイズ[バイト]。
+             */
+            size_t size(void) const
+            {
+                return Size_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 溜めているレコード数を取得
+             *
+             * @return 溜めているレコード数。
+             */
+            size_t getRecordCount(void) const
+            {
+                return RecordCount_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信した回数を取得
+             *
+             * @return 送信した回数。
+             */
+            size_t getFlushCount(void) const
+            {
+                return FlushCount_;
+            }
+
+            /**
+             * @~Japanese
+             * @brief 送信したサイズを取得
+             *
+             * @return 送信したサイズの合計[バイト]。
+             */
+            size_t getFlushedSize(void) const
+            {
+                return FlushedSize_;
+            }
+        };
+
+    }
+}
+
+#endif // UPLINKBATCHER_HPP